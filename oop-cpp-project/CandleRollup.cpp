@@ -0,0 +1,259 @@
+#include "CandleRollup.h"
+#include "DateTime.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+namespace {
+
+// Parent bucket ids, in the id spaces of TimeBucketer
+int64_t weekOfDay(int64_t day) { return floorDiv(day + 3, 7); }
+int64_t monthOfDay(int64_t day) {
+    CivilTime civil = civilFromDays(day);
+    return civil.year * 12LL + (civil.month - 1);
+}
+int64_t quarterOfMonth(int64_t month) { return floorDiv(month, 3); }
+int64_t yearOfQuarter(int64_t quarter) { return floorDiv(quarter, 4); }
+
+} // namespace
+
+/**
+ * Aggregates the hourly column into day buckets, then merges each level into
+ * the next. Days come from assignTimeBuckets, so rows out of time order still
+ * land in their one day bucket, as in computeCandlestickData. A day's open and
+ * close are its earliest and latest readings by timestamp, not by row.
+ *
+ * @param table The parsed weather table.
+ * @param country_prefix The country prefix.
+ * @param with_quantiles Also build a quantile sketch per bucket.
+ */
+CandleRollup::CandleRollup(const WeatherTable& table, const std::string& country_prefix, bool with_quantiles)
+    : table_(&table), country_(country_prefix), with_quantiles_(with_quantiles) {
+    const std::vector<double>& temps = table.temperatureColumn(country_prefix);
+    Level& days = levels_[kDay];
+
+    std::vector<uint32_t> row_day;
+    days.ids = assignTimeBuckets(table.timestamps, TimeFrame::Day, row_day);
+    days.ohlc.resize(days.ids.size());
+    if (with_quantiles) {
+        days.sketches.resize(days.ids.size());
+    }
+
+    // Missing readings are skipped a bitmap word at a time
+    const bool in_order = std::is_sorted(table.timestamps.begin(), table.timestamps.end());
+    std::vector<int64_t> first_time(in_order ? 0 : days.ids.size()), last_time(first_time.size());
+    table.temperatureValidity(country_prefix).forEachValid(0, table.rowCount(), [&](size_t i) {
+        const uint32_t d = row_day[i];
+        if (in_order) {
+            days.ohlc[d].add(temps[i]);
+        } else {
+            days.ohlc[d].addAt(temps[i], table.timestamps[i], first_time[d], last_time[d]);
+        }
+        if (with_quantiles) {
+            days.sketches[row_day[i]].add(temps[i]);
+        }
+    });
+
+    // Drop days without a reading, as the candle series does
+    size_t kept = 0;
+    for (size_t d = 0; d < days.ids.size(); ++d) {
+        if (days.ohlc[d].empty()) {
+            continue;
+        }
+        if (kept != d) {
+            days.ids[kept] = days.ids[d];
+            days.ohlc[kept] = days.ohlc[d];
+            if (with_quantiles) {
+                days.sketches[kept] = std::move(days.sketches[d]);
+            }
+        }
+        if (with_quantiles) {
+            days.sketches[kept].compress();
+        }
+        ++kept;
+    }
+    days.ids.resize(kept);
+    days.ohlc.resize(kept);
+    if (with_quantiles) {
+        days.sketches.resize(kept);
+    }
+
+    levels_[kWeek] = mergeLevel(levels_[kDay], weekOfDay);
+    levels_[kMonth] = mergeLevel(levels_[kDay], monthOfDay);
+    levels_[kQuarter] = mergeLevel(levels_[kMonth], quarterOfMonth);
+    levels_[kYear] = mergeLevel(levels_[kQuarter], yearOfQuarter);
+    levels_[kDecade] = mergeLevel(levels_[kYear], decadeOfYear);
+}
+
+/**
+ * Builds the next coarser level by merging runs of children that share a parent id.
+ *
+ * @param finer The level to merge.
+ * @param parent_id Maps a child id to its parent id.
+ * @return The merged level.
+ */
+CandleRollup::Level CandleRollup::mergeLevel(const Level& finer, int64_t (*parent_id)(int64_t)) {
+    Level coarser;
+    const bool sketched = !finer.sketches.empty();
+    for (size_t i = 0; i < finer.ids.size(); ++i) {
+        int64_t id = parent_id(finer.ids[i]);
+        if (coarser.ids.empty() || coarser.ids.back() != id) {
+            coarser.ids.push_back(id);
+            coarser.ohlc.emplace_back();
+            if (sketched) {
+                coarser.sketches.emplace_back();
+            }
+        }
+        coarser.ohlc.back().merge(finer.ohlc[i]);
+        if (sketched) {
+            coarser.sketches.back().merge(finer.sketches[i]);
+        }
+    }
+
+    // Compressed sketches are never modified by quantile(), so readers can share them
+    for (auto& sketch : coarser.sketches) {
+        sketch.compress();
+    }
+    return coarser;
+}
+
+/**
+ * Maps a time frame to its level, or -1 if it is finer than a day.
+ *
+ * @param time_frame The time frame.
+ * @return The level index.
+ */
+int CandleRollup::levelIndex(const TimeFrameSpec& time_frame) {
+    switch (time_frame.frame) {
+        case TimeFrame::Day: return kDay;
+        case TimeFrame::Week: return kWeek;
+        case TimeFrame::Month: return kMonth;
+        case TimeFrame::Quarter: return kQuarter;
+        case TimeFrame::Year: return kYear;
+        case TimeFrame::Decade: return kDecade;
+        default: return -1;
+    }
+}
+
+/**
+ * Materialises the candlesticks of one time frame.
+ *
+ * @param time_frame The time frame.
+ * @return Candlesticks ordered by date.
+ */
+std::vector<Candlestick> CandleRollup::candles(const TimeFrameSpec& time_frame) const {
+    if (table_ == nullptr) {
+        return {};
+    }
+
+    int level = levelIndex(time_frame);
+    if (level == -1) {
+        return computeCandlestickData(*table_, country_, time_frame);
+    }
+
+    const Level& data = levels_[level];
+    std::vector<Candlestick> result;
+    result.reserve(data.ids.size());
+    for (size_t i = 0; i < data.ids.size(); ++i) {
+        result.push_back(data.ohlc[i].toCandlestick(timeBucketLabel(data.ids[i], time_frame)));
+    }
+    return result;
+}
+
+/**
+ * Counts the candles at a time frame.
+ *
+ * @param time_frame The time frame.
+ * @return The number of candles.
+ */
+size_t CandleRollup::size(const TimeFrameSpec& time_frame) const {
+    int level = levelIndex(time_frame);
+    if (level == -1) {
+        return candles(time_frame).size();
+    }
+    return levels_[level].ids.size();
+}
+
+/**
+ * Reads each candle's sketch, or for frames finer than a day, sketches the
+ * table's readings per bucket.
+ *
+ * @param time_frame The time frame.
+ * @param probabilities The quantiles to estimate.
+ * @return One row of estimates per candle.
+ */
+CandleQuantiles CandleRollup::quantiles(const TimeFrameSpec& time_frame,
+                                        const std::vector<double>& probabilities) const {
+    if (!with_quantiles_) {
+        throw std::runtime_error("Rollup for " + country_ + " was built without quantiles");
+    }
+
+    CandleQuantiles result;
+    result.probabilities = probabilities;
+    auto append = [&](int64_t id, const QuantileSketch& sketch) {
+        result.dates.push_back(timeBucketLabel(id, time_frame));
+        for (double probability : probabilities) {
+            result.values.push_back(sketch.quantile(probability));
+        }
+    };
+
+    int level = levelIndex(time_frame);
+    if (level != -1) {
+        const Level& data = levels_[level];
+        for (size_t i = 0; i < data.ids.size(); ++i) {
+            append(data.ids[i], data.sketches[i]);
+        }
+        return result;
+    }
+
+    // Finer than a day: one sketch per non-empty bucket, straight from the table
+    std::vector<uint32_t> row_bucket;
+    std::vector<int64_t> ids = assignTimeBuckets(table_->timestamps, time_frame, row_bucket);
+    std::vector<QuantileSketch> sketches(ids.size());
+    const std::vector<double>& temps = table_->temperatureColumn(country_);
+    table_->temperatureValidity(country_).forEachValid(0, temps.size(), [&](size_t i) {
+        sketches[row_bucket[i]].add(temps[i]);
+    });
+    for (size_t b = 0; b < ids.size(); ++b) {
+        if (!sketches[b].empty()) {
+            append(ids[b], sketches[b]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Builds one rollup per requested country.
+ *
+ * @param table The parsed weather table.
+ * @param country_prefixes The countries; empty means every country.
+ * @return A map from country prefix to its rollup.
+ */
+std::map<std::string, CandleRollup> buildCandleRollups(
+    const WeatherTable& table,
+    const std::vector<std::string>& country_prefixes) {
+    std::map<std::string, CandleRollup> rollups;
+    for (const auto& country : country_prefixes.empty() ? table.countryPrefixes() : country_prefixes) {
+        rollups.emplace(country, CandleRollup(table, country));
+    }
+    return rollups;
+}
+
+/**
+ * Looks up one country's rollup.
+ *
+ * @param rollups Rollups from buildCandleRollups.
+ * @param country_prefix The country prefix.
+ * @return The country's rollup.
+ */
+const CandleRollup& findCandleRollup(const std::map<std::string, CandleRollup>& rollups,
+                                     const std::string& country_prefix) {
+    auto it = rollups.find(country_prefix);
+    if (it == rollups.end()) {
+        throw std::runtime_error("Temperature column not found for " + country_prefix);
+    }
+    return it->second;
+}
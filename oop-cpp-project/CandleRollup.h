@@ -0,0 +1,139 @@
+#ifndef CANDLE_ROLLUP_H
+#define CANDLE_ROLLUP_H
+
+#include "Candlestick.h"
+#include "CandlestickAggregator.h"
+#include "QuantileSketch.h"
+#include "TimeFrame.h"
+#include "WeatherTable.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Estimated quantiles of a candle series, one row per candle.
+ */
+struct CandleQuantiles {
+    std::vector<std::string> dates;    // Candle labels, as in the candle series.
+    std::vector<double> probabilities; // The requested quantiles.
+    std::vector<double> values;        // dates.size() x probabilities.size(), row-major.
+
+    double value(size_t candle, size_t probability) const {
+        return values[candle * probabilities.size() + probability];
+    }
+};
+
+/**
+ * @brief Precomputed candle pyramid for one country.
+ *
+ * The day level is aggregated from the hourly readings once; rows need not be
+ * in time order. Every coarser level is built by merging the level below it
+ * (open of the first child, close of the last, max of highs, min of lows), so
+ * no level ever rescans the raw data:
+ *
+ *     hour -> day -> month -> quarter -> year -> decade
+ *                \-> week
+ *
+ * Hour and N-hour frames are the table's own resolution and are computed from
+ * it on demand, which means the table must outlive the rollup.
+ *
+ * Optionally every bucket also carries a QuantileSketch. Day sketches are fed
+ * the hourly readings, and each coarser sketch is the merge of its children's,
+ * so p5/p50/p95 per month or year cost a bounded amount of memory per bucket.
+ */
+class CandleRollup {
+public:
+    CandleRollup() = default;
+
+    /**
+     * @brief Builds the pyramid for one country.
+     *
+     * @param table The parsed weather table; rows may be in any order.
+     * @param country_prefix The country prefix (e.g., "AT" for Austria).
+     * @param with_quantiles Also build a quantile sketch per bucket (see quantiles).
+     * @throws std::runtime_error if the country is unknown.
+     */
+    CandleRollup(const WeatherTable& table, const std::string& country_prefix, bool with_quantiles = false);
+
+    /**
+     * @brief Returns the candlesticks for a time frame.
+     *
+     * @param time_frame Any time frame; day and coarser are read from the pyramid.
+     * @return Candlesticks ordered by date, labelled as by timeBucketLabel.
+     */
+    std::vector<Candlestick> candles(const TimeFrameSpec& time_frame) const;
+
+    /**
+     * @brief Returns the number of candles at a time frame.
+     */
+    size_t size(const TimeFrameSpec& time_frame) const;
+
+    /**
+     * @brief Estimates quantiles of the readings in every candle of a time frame.
+     *
+     * Day and coarser frames are read from the merged sketches; finer frames
+     * are sketched from the table on demand.
+     *
+     * @param time_frame Any time frame.
+     * @param probabilities The quantiles to estimate, each in [0, 1] (e.g., {0.05, 0.5, 0.95}).
+     * @return One row per candle, in the order of candles(time_frame).
+     * @throws std::runtime_error if the rollup was built without quantiles.
+     */
+    CandleQuantiles quantiles(const TimeFrameSpec& time_frame, const std::vector<double>& probabilities) const;
+
+    bool hasQuantiles() const { return with_quantiles_; }
+
+    /**
+     * @brief Whether a time frame is stored in the pyramid (day and coarser).
+     */
+    static bool hasLevel(const TimeFrameSpec& time_frame) { return levelIndex(time_frame) != -1; }
+
+    const std::string& country() const { return country_; }
+
+private:
+    /**
+     * Bucket ids and running OHLC of one level, both in date order.
+     */
+    struct Level {
+        std::vector<int64_t> ids;
+        std::vector<OhlcAccumulator> ohlc;
+        std::vector<QuantileSketch> sketches; // Empty unless built with quantiles.
+    };
+
+    enum LevelIndex { kDay, kWeek, kMonth, kQuarter, kYear, kDecade, kLevelCount };
+
+    static Level mergeLevel(const Level& finer, int64_t (*parent_id)(int64_t));
+    static int levelIndex(const TimeFrameSpec& time_frame);
+
+    const WeatherTable* table_ = nullptr;
+    std::string country_;
+    bool with_quantiles_ = false;
+    Level levels_[kLevelCount];
+};
+
+/**
+ * @brief Builds rollups for several countries.
+ *
+ * @param table The parsed weather table; must outlive the result.
+ * @param country_prefixes The countries to build; empty means every country.
+ * @return A map from country prefix to its rollup.
+ */
+std::map<std::string, CandleRollup> buildCandleRollups(
+    const WeatherTable& table,
+    const std::vector<std::string>& country_prefixes = {}
+);
+
+/**
+ * @brief Returns one country's rollup from buildCandleRollups.
+ *
+ * @param rollups The rollups.
+ * @param country_prefix The country prefix.
+ * @return The rollup.
+ * @throws std::runtime_error if the country has no rollup.
+ */
+const CandleRollup& findCandleRollup(const std::map<std::string, CandleRollup>& rollups,
+                                     const std::string& country_prefix);
+
+#endif // CANDLE_ROLLUP_H
@@ -0,0 +1,224 @@
+#include "CandleView.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// --- CandleView ---
+
+/**
+ * Creates a view over a whole series.
+ *
+ * @param candlesticks The series, sorted by date.
+ * @param country The country the series belongs to.
+ */
+CandleView::CandleView(const std::vector<Candlestick>& candlesticks, std::string country)
+    : candlesticks_(&candlesticks), country_(std::move(country)), first_(0), last_(candlesticks.size()) {}
+
+/**
+ * Narrows the index range with two binary searches.
+ *
+ * @param start_date The first date to keep (inclusive).
+ * @param end_date The last date to keep (inclusive).
+ * @return This view.
+ */
+CandleView& CandleView::dateRange(const std::string& start_date, const std::string& end_date) {
+    auto begin = candlesticks_->begin() + first_;
+    auto end = candlesticks_->begin() + last_;
+
+    auto lower = std::lower_bound(begin, end, start_date, [](const Candlestick& candle, const std::string& date) {
+        return candle.date < date;
+    });
+    auto upper = std::upper_bound(lower, end, end_date, [](const std::string& date, const Candlestick& candle) {
+        return date < candle.date;
+    });
+
+    first_ = static_cast<size_t>(lower - candlesticks_->begin());
+    last_ = std::max(first_, static_cast<size_t>(upper - candlesticks_->begin()));
+    return *this;
+}
+
+/**
+ * Intersects the temperature band. An empty intersection empties the view.
+ *
+ * @param min_temp The minimum temperature.
+ * @param max_temp The maximum temperature.
+ * @return This view.
+ */
+CandleView& CandleView::temperatureRange(double min_temp, double max_temp) {
+    if (!has_band_) {
+        band_low_ = min_temp;
+        band_high_ = max_temp;
+        has_band_ = true;
+    } else {
+        band_low_ = std::max(band_low_, min_temp);
+        band_high_ = std::min(band_high_, max_temp);
+    }
+    if (band_low_ > band_high_) {
+        last_ = first_;
+    }
+    findMatches();
+    return *this;
+}
+
+/**
+ * Attaches the index and, if a band is already set, looks it up.
+ *
+ * @param index An interval index over this view's series.
+ * @return This view.
+ */
+CandleView& CandleView::bandIndex(const TemperatureIntervalIndex& index) {
+    if (&index.series() != candlesticks_) {
+        throw std::runtime_error("Interval index was built over a different series");
+    }
+    band_index_ = &index;
+    findMatches();
+    return *this;
+}
+
+/**
+ * Refreshes the indexed matches for the current band.
+ */
+void CandleView::findMatches() {
+    if (indexed()) {
+        matches_ = band_index_->overlapping(band_low_, band_high_);
+    }
+}
+
+/**
+ * Series position of a match, or last_ once the matches leave the date range.
+ *
+ * @param match The position in matches_.
+ * @return The series position.
+ */
+size_t CandleView::matchPosition(size_t match) const {
+    return match < matches_.size() && matches_[match] < last_ ? matches_[match] : last_;
+}
+
+/**
+ * Empties the view unless the series belongs to the given country.
+ *
+ * @param country_prefix The country prefix to keep.
+ * @return This view.
+ */
+CandleView& CandleView::country(const std::string& country_prefix) {
+    if (country_ != country_prefix) {
+        last_ = first_;
+    }
+    return *this;
+}
+
+/**
+ * Adds a custom predicate.
+ *
+ * @param predicate Returns true for candles to keep.
+ * @return This view.
+ */
+CandleView& CandleView::where(Predicate predicate) {
+    predicates_.push_back(std::move(predicate));
+    return *this;
+}
+
+/**
+ * Applies the temperature band and predicates to one candle.
+ *
+ * @param source The candle from the series.
+ * @param out Receives the (possibly truncated) candle; its string buffer is reused.
+ * @return True if the candle is in the view.
+ */
+bool CandleView::apply(const Candlestick& source, Candlestick& out) const {
+    if (has_band_ && (source.high < band_low_ || source.low > band_high_)) {
+        return false;
+    }
+
+    out.date.assign(source.date);
+    out.open = source.open;
+    out.high = source.high;
+    out.low = source.low;
+    out.close = source.close;
+    out.count = source.count;
+    out.sum = source.sum;
+
+    if (has_band_) {
+        out.truncate(band_low_, band_high_);
+    }
+
+    for (const auto& predicate : predicates_) {
+        if (!predicate(out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Counts the candles in the view by iterating it.
+ *
+ * @return The number of candles.
+ */
+size_t CandleView::count() const {
+    if (!has_band_ && predicates_.empty()) {
+        return last_ - first_;
+    }
+    if (indexed() && predicates_.empty()) {
+        auto lower = std::lower_bound(matches_.begin(), matches_.end(), first_);
+        auto upper = std::lower_bound(lower, matches_.end(), last_);
+        return static_cast<size_t>(upper - lower);
+    }
+    return static_cast<size_t>(std::distance(begin(), end()));
+}
+
+/**
+ * Copies the view into a vector.
+ *
+ * @return The filtered candles.
+ */
+std::vector<Candlestick> CandleView::materialize() const {
+    std::vector<Candlestick> result;
+    if (!has_band_ && predicates_.empty()) {
+        result.reserve(last_ - first_);
+    } else if (indexed()) {
+        result.reserve(matches_.size());
+    }
+    for (const auto& candle : *this) {
+        result.push_back(candle);
+    }
+    return result;
+}
+
+// --- CandleView::iterator ---
+
+CandleView::iterator::iterator(const CandleView* view, size_t index)
+    : view_(view), index_(index), current_("", 0, 0, 0, 0) {
+    if (view_->indexed() && index_ < view_->last_) {
+        const std::vector<size_t>& matches = view_->matches_;
+        match_ = static_cast<size_t>(std::lower_bound(matches.begin(), matches.end(), index_) - matches.begin());
+        index_ = view_->matchPosition(match_);
+    }
+    settle();
+}
+
+CandleView::iterator& CandleView::iterator::operator++() {
+    advance();
+    settle();
+    return *this;
+}
+
+/**
+ * Moves to the next candidate: the next indexed match, or the next candle.
+ */
+void CandleView::iterator::advance() {
+    if (view_->indexed()) {
+        index_ = view_->matchPosition(++match_);
+    } else {
+        ++index_;
+    }
+}
+
+/**
+ * Advances to the next candle that passes the filters, or to the end.
+ */
+void CandleView::iterator::settle() {
+    while (index_ < view_->last_ && !view_->apply((*view_->candlesticks_)[index_], current_)) {
+        advance();
+    }
+}
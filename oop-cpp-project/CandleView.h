@@ -0,0 +1,129 @@
+#ifndef CANDLE_VIEW_H
+#define CANDLE_VIEW_H
+
+#include "Candlestick.h"
+#include "TemperatureIntervalIndex.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Lazy, composable filter over a date-sorted candlestick series.
+ *
+ * Filters only narrow the view; nothing is copied until materialize() is
+ * called. Date ranges become a binary-searched index range, temperature ranges
+ * are intersected into a single band, and custom predicates are checked while
+ * iterating. Iteration reuses one Candlestick per iterator, so walking the view
+ * does not allocate. With a TemperatureIntervalIndex attached, a band visits
+ * only the candles the index reports instead of scanning the date range.
+ *
+ * The series must be sorted by date (every candle producer in this project
+ * returns them that way) and must outlive the view.
+ */
+class CandleView {
+public:
+    using Predicate = std::function<bool(const Candlestick&)>;
+
+    /**
+     * @brief Creates a view over a whole series.
+     *
+     * @param candlesticks The series, sorted by date.
+     * @param country The country the series belongs to, used by country(); may be empty.
+     */
+    explicit CandleView(const std::vector<Candlestick>& candlesticks, std::string country = "");
+
+    /**
+     * @brief Keeps candles whose date is within [start_date, end_date], compared as strings.
+     */
+    CandleView& dateRange(const std::string& start_date, const std::string& end_date);
+
+    /**
+     * @brief Keeps candles overlapping [min_temp, max_temp] and truncates them to it,
+     * exactly as filterByTemperatureRange does. Several bands intersect.
+     */
+    CandleView& temperatureRange(double min_temp, double max_temp);
+
+    /**
+     * @brief Answers the temperature band from an interval index over the same series.
+     *
+     * @param index The index; must be built over this view's series and outlive the view.
+     * @throws std::runtime_error if the index covers a different series.
+     */
+    CandleView& bandIndex(const TemperatureIntervalIndex& index);
+
+    /**
+     * @brief Keeps the series only if it belongs to the given country.
+     */
+    CandleView& country(const std::string& country_prefix);
+
+    /**
+     * @brief Adds a custom predicate. It sees candles after temperature truncation.
+     */
+    CandleView& where(Predicate predicate);
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Candlestick;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Candlestick*;
+        using reference = const Candlestick&;
+
+        iterator(const CandleView* view, size_t index);
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+        iterator& operator++();
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+        /**
+         * @brief Position of the current candle in the underlying series.
+         */
+        size_t position() const { return index_; }
+
+    private:
+        void advance();
+        void settle();
+
+        const CandleView* view_;
+        size_t index_;
+        size_t match_ = 0; // Position in view_->matches_ when the band is indexed.
+        Candlestick current_;
+    };
+
+    iterator begin() const { return iterator(this, first_); }
+    iterator end() const { return iterator(this, last_); }
+
+    /**
+     * @brief Counts the candles in the view.
+     */
+    size_t count() const;
+
+    /**
+     * @brief Copies the candles in the view into a new vector.
+     */
+    std::vector<Candlestick> materialize() const;
+
+private:
+    bool apply(const Candlestick& source, Candlestick& out) const;
+    bool indexed() const { return has_band_ && band_index_ != nullptr; }
+    size_t matchPosition(size_t match) const;
+    void findMatches();
+
+    const std::vector<Candlestick>* candlesticks_;
+    std::string country_;
+    size_t first_;
+    size_t last_;
+    bool has_band_ = false;
+    double band_low_ = 0.0;
+    double band_high_ = 0.0;
+    std::vector<Predicate> predicates_;
+    const TemperatureIntervalIndex* band_index_ = nullptr;
+    std::vector<size_t> matches_; // Series positions overlapping the band, when indexed.
+};
+
+#endif // CANDLE_VIEW_H
@@ -1,36 +1,65 @@
-#ifndef CANDLESTICK_H
-#define CANDLESTICK_H
-
-#include <string>
-
-/**
- * @brief Represents a candlestick data structure for temperature analysis.
- *
- * Each Candlestick instance encapsulates a time frame (e.g., year, month, or day)
- * along with temperature statistics for that period, including:
- * - Opening temperature
- * - Highest temperature
- * - Lowest temperature
- * - Closing temperature
- */
-struct Candlestick {
-    std::string date;  // Time frame (e.g., year, month, or day).
-    double open;       // Opening temperature.
-    double high;       // Highest temperature.
-    double low;        // Lowest temperature.
-    double close;      // Closing temperature.
-
-    /**
-     * @brief Constructs a Candlestick instance.
-     *
-     * @param d The time frame (e.g., year, month, or day).
-     * @param o The opening temperature.
-     * @param h The highest temperature.
-     * @param l The lowest temperature.
-     * @param c The closing temperature.
-     */
-    Candlestick(std::string d, double o, double h, double l, double c)
-        : date(d), open(o), high(h), low(l), close(c) {}
-};
-
-#endif // CANDLESTICK_H
+#ifndef CANDLESTICK_H
+#define CANDLESTICK_H
+
+#include <algorithm>
+#include <string>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Represents a candlestick data structure for temperature analysis.
+ *
+ * Each Candlestick instance encapsulates a time frame (e.g., year, month, or day)
+ * along with temperature statistics for that period, including:
+ * - Opening temperature
+ * - Highest temperature
+ * - Lowest temperature
+ * - Closing temperature
+ * - Number and sum of the readings aggregated into it (when known)
+ */
+struct Candlestick {
+    std::string date;  // Time frame (e.g., year, month, or day).
+    double open;       // Opening temperature.
+    double high;       // Highest temperature.
+    double low;        // Lowest temperature.
+    double close;      // Closing temperature.
+    size_t count;      // Number of readings in the time frame (0 if unknown).
+    double sum;        // Sum of the readings in the time frame.
+
+    /**
+     * @brief Constructs a Candlestick instance.
+     *
+     * @param d The time frame (e.g., year, month, or day).
+     * @param o The opening temperature.
+     * @param h The highest temperature.
+     * @param l The lowest temperature.
+     * @param c The closing temperature.
+     * @param n The number of readings aggregated.
+     * @param s The sum of the readings aggregated.
+     */
+    Candlestick(std::string d, double o, double h, double l, double c, size_t n = 0, double s = 0.0)
+        : date(std::move(d)), open(o), high(h), low(l), close(c), count(n), sum(s) {}
+
+    /**
+     * @brief Returns the mean reading, or the high/low midpoint if the count is unknown.
+     */
+    double mean() const { return count > 0 ? sum / count : (high + low) / 2; }
+
+    /**
+     * @brief Truncates the candle to a temperature band it overlaps.
+     *
+     * High and low are cut to the band and open/close are clamped into the
+     * result, as filterByTemperatureRange does.
+     *
+     * @param min_temp The bottom of the band.
+     * @param max_temp The top of the band.
+     */
+    void truncate(double min_temp, double max_temp) {
+        high = std::min(high, max_temp);
+        low = std::max(low, min_temp);
+        open = std::clamp(open, low, high);
+        close = std::clamp(close, low, high);
+    }
+};
+
+#endif // CANDLESTICK_H
@@ -0,0 +1,94 @@
+#include "CandlestickAggregator.h"
+#include "CsvReader.h"
+#include "DateTime.h"
+#include "WeatherTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// --- CandlestickAggregator ---
+
+/**
+ * Creates an aggregator for one time frame.
+ *
+ * @param time_frame The time frame to bucket readings by.
+ * @param on_candle Receives every finished candlestick.
+ */
+CandlestickAggregator::CandlestickAggregator(const TimeFrameSpec& time_frame, CandleCallback on_candle)
+    : time_frame_(time_frame), on_candle_(std::move(on_candle)) {
+    bucket_id_ = withTimeBucketer(time_frame_, [](auto bucketer) {
+        return &decltype(bucketer)::bucketId;
+    });
+}
+
+/**
+ * Folds a reading into the current bucket, closing the bucket first if the
+ * reading belongs to a different one.
+ *
+ * @param timestamp Seconds since the Unix epoch.
+ * @param value The reading.
+ */
+void CandlestickAggregator::add(int64_t timestamp, double value) {
+    int64_t id = bucket_id_(timestamp, time_frame_.interval_hours);
+    if (id != current_id_ && !current_.empty()) {
+        finish();
+    }
+    current_id_ = id;
+    current_.add(value);
+}
+
+/**
+ * Emits the open bucket, if any, and resets the state.
+ */
+void CandlestickAggregator::finish() {
+    if (current_.empty()) {
+        return;
+    }
+    on_candle_(current_.toCandlestick(timeBucketLabel(current_id_, time_frame_)));
+    ++emitted_;
+    current_ = OhlcAccumulator();
+}
+
+// --- Streaming from a file ---
+
+/**
+ * Reads the CSV once through a bounded window and feeds one temperature column
+ * into an aggregator.
+ *
+ * @param filename The name of the CSV file.
+ * @param country_prefix The country prefix.
+ * @param time_frame The time frame.
+ * @param on_candle Receives every finished candlestick.
+ * @return The number of candlesticks emitted.
+ */
+size_t streamCandlestickData(
+    const std::string& filename,
+    const std::string& country_prefix,
+    const TimeFrameSpec& time_frame,
+    const CandlestickAggregator::CandleCallback& on_candle) {
+    CsvStreamReader reader(filename);
+    std::vector<std::string_view> cells;
+    if (!reader.isOpen() || !reader.nextRow(cells)) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    const std::string column_name = country_prefix + "_temperature";
+    auto it = std::find(cells.begin(), cells.end(), column_name);
+    if (it == cells.end()) {
+        throw std::runtime_error("Temperature column not found for " + country_prefix);
+    }
+    const size_t temp_column = static_cast<size_t>(it - cells.begin());
+
+    CandlestickAggregator aggregator(time_frame, on_candle);
+    while (reader.nextRow(cells)) {
+        int64_t timestamp;
+        double temp;
+        if (temp_column < cells.size() && parseTimestamp(cells[0], timestamp) &&
+            parseDouble(cells[temp_column], temp)) {
+            aggregator.add(timestamp, temp);
+        }
+    }
+
+    aggregator.finish();
+    return aggregator.emitted();
+}
@@ -0,0 +1,163 @@
+#ifndef CANDLESTICK_AGGREGATOR_H
+#define CANDLESTICK_AGGREGATOR_H
+
+#include "Candlestick.h"
+#include "TimeFrame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Running open/high/low/close state of one time bucket.
+ *
+ * Uses O(1) memory regardless of how many readings fall into the bucket.
+ */
+struct OhlcAccumulator {
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double sum = 0.0;
+    size_t count = 0;
+
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Adds the next reading, in time order.
+     */
+    void add(double value) {
+        if (count == 0) {
+            open = high = low = value;
+        } else {
+            high = std::max(high, value);
+            low = std::min(low, value);
+        }
+        close = value;
+        sum += value;
+        ++count;
+    }
+
+    /**
+     * @brief Adds a reading that may arrive out of time order.
+     *
+     * Open and close follow the earliest and latest timestamps rather than the
+     * order of the calls; ties keep the first and the last reading added.
+     * first_time and last_time hold those timestamps for this bucket.
+     */
+    void addAt(double value, int64_t time, int64_t& first_time, int64_t& last_time) {
+        if (empty()) {
+            first_time = last_time = time;
+            add(value);
+            return;
+        }
+        const double earlier_close = close;
+        add(value);
+        if (time < first_time) {
+            first_time = time;
+            open = value;
+        }
+        if (time >= last_time) {
+            last_time = time;
+        } else {
+            close = earlier_close;
+        }
+    }
+
+    /**
+     * @brief Merges the state of a bucket that immediately follows this one in time.
+     */
+    void merge(const OhlcAccumulator& later) {
+        if (later.empty()) {
+            return;
+        }
+        if (empty()) {
+            *this = later;
+            return;
+        }
+        high = std::max(high, later.high);
+        low = std::min(low, later.low);
+        close = later.close;
+        sum += later.sum;
+        count += later.count;
+    }
+
+    /**
+     * @brief Builds the finished candlestick for this bucket.
+     */
+    Candlestick toCandlestick(std::string date) const {
+        return Candlestick(std::move(date), open, high, low, close, count, sum);
+    }
+};
+
+/**
+ * @brief Streaming candlestick builder for time-ordered readings.
+ *
+ * Readings are folded into the current bucket as they arrive. As soon as a
+ * reading belongs to a different bucket, the finished candlestick is handed to
+ * the callback and its state is discarded, so memory use is constant no matter
+ * how long the input is. Input must be ordered by time; a reading that goes
+ * back in time simply starts a new bucket.
+ */
+class CandlestickAggregator {
+public:
+    using CandleCallback = std::function<void(const Candlestick&)>;
+
+    /**
+     * @brief Creates an aggregator.
+     *
+     * @param time_frame The time frame to bucket readings by.
+     * @param on_candle Called with each finished candlestick, in time order.
+     */
+    CandlestickAggregator(const TimeFrameSpec& time_frame, CandleCallback on_candle);
+
+    /**
+     * @brief Adds one reading.
+     *
+     * @param timestamp Seconds since the Unix epoch.
+     * @param value The reading (e.g., a temperature).
+     */
+    void add(int64_t timestamp, double value);
+
+    /**
+     * @brief Emits the bucket that is still open. Call once after the last reading.
+     */
+    void finish();
+
+    /**
+     * @brief Returns the number of candlesticks emitted so far.
+     */
+    size_t emitted() const { return emitted_; }
+
+private:
+    TimeFrameSpec time_frame_;
+    int64_t (*bucket_id_)(int64_t, int);  // The TimeBucketer for time_frame_, chosen once.
+    CandleCallback on_candle_;
+    OhlcAccumulator current_;
+    int64_t current_id_ = 0;
+    size_t emitted_ = 0;
+};
+
+/**
+ * @brief Streams a weather CSV and builds one country's candlesticks in constant memory.
+ *
+ * The file is read through a fixed-size window (see CsvStreamReader) and walked
+ * row by row; no table is built and nothing is mapped, so memory use does not
+ * grow with the file. Empty or invalid temperature cells are skipped.
+ *
+ * @param filename The name of the CSV file.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame to bucket readings by.
+ * @param on_candle Called with each finished candlestick, in time order.
+ * @return The number of candlesticks emitted.
+ * @throws std::runtime_error if the file cannot be read or the country is unknown.
+ */
+size_t streamCandlestickData(
+    const std::string& filename,
+    const std::string& country_prefix,
+    const TimeFrameSpec& time_frame,
+    const CandlestickAggregator::CandleCallback& on_candle
+);
+
+#endif // CANDLESTICK_AGGREGATOR_H
@@ -0,0 +1,133 @@
+#include "CandlestickRenderer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const size_t kCellWidth = 7;
+
+/**
+ * Row of a temperature, truncated toward zero like the original plot.
+ * Non-finite positions map to a row that is never drawn.
+ */
+int rowOf(double value, double low, double range, int height) {
+    double position = (value - low) / range * height;
+    if (!std::isfinite(position) || position <= INT_MIN || position >= INT_MAX) {
+        return INT_MIN;
+    }
+    return static_cast<int>(position);
+}
+
+} // namespace
+
+CandlestickRenderer::CandlestickRenderer(int plot_height) : plot_height_(plot_height) {}
+
+/**
+ * Builds the frame: grid first, then labels and footer around it.
+ *
+ * @param candlesticks The candles to draw, left to right.
+ * @param overlays Lines to draw behind the candles.
+ * @return The full chart, newline-terminated.
+ */
+std::string CandlestickRenderer::render(const std::vector<Candlestick>& candlesticks,
+                                        const std::vector<PlotOverlay>& overlays) const {
+    if (candlesticks.empty()) {
+        return "No candlestick data to plot.\n";
+    }
+
+    double global_high = -1e9, global_low = 1e9;
+    for (const auto& candle : candlesticks) {
+        global_high = std::max(global_high, candle.high);
+        global_low = std::min(global_low, candle.low);
+    }
+    for (const auto& overlay : overlays) {
+        for (double value : overlay.values) {
+            if (std::isfinite(value)) {
+                global_high = std::max(global_high, value);
+                global_low = std::min(global_low, value);
+            }
+        }
+    }
+
+    double range = global_high - global_low;
+    if (range == 0) range = 1; // Prevent division by zero
+
+    int height = std::min(plot_height_, static_cast<int>(range * 2));
+    height = std::max(height, 10);
+    const size_t rows = static_cast<size_t>(height) + 1;
+    const size_t width = candlesticks.size() * kCellWidth;
+
+    // grid[r * width + x] holds the cell text for row `height - r` (top row first).
+    std::string grid(rows * width, ' ');
+    auto paint = [&](size_t column, int row, char glyph) {
+        if (row >= 0 && row <= height) {
+            grid[static_cast<size_t>(height - row) * width + column] = glyph;
+        }
+    };
+
+    // Overlay segments, interpolated across each cell towards the next candle's value
+    for (const auto& overlay : overlays) {
+        const size_t points = std::min(overlay.values.size(), candlesticks.size());
+        for (size_t c = 0; c < points; ++c) {
+            double value = overlay.values[c];
+            if (!std::isfinite(value)) {
+                continue;
+            }
+            bool joined = c + 1 < points && std::isfinite(overlay.values[c + 1]);
+            size_t steps = joined ? kCellWidth : 1;
+            for (size_t step = 0; step < steps; ++step) {
+                double t = static_cast<double>(step) / kCellWidth;
+                double position = joined ? value + (overlay.values[c + 1] - value) * t : value;
+                paint(c * kCellWidth + step, rowOf(position, global_low, range, height), overlay.glyph);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < candlesticks.size(); ++c) {
+        const Candlestick& candle = candlesticks[c];
+        int high_row = rowOf(candle.high, global_low, range, height);
+        int low_row = rowOf(candle.low, global_low, range, height);
+        int open_row = rowOf(candle.open, global_low, range, height);
+        int close_row = rowOf(candle.close, global_low, range, height);
+        size_t column = c * kCellWidth;
+
+        // Paint in reverse priority so later glyphs win: body, close, open, low, high.
+        if (high_row != INT_MIN && low_row != INT_MIN) {
+            int first = std::max(low_row + 1, 0);
+            int last = std::min(high_row - 1, height);
+            for (int row = first; row <= last; ++row) {
+                paint(column, row, '|');
+            }
+        }
+        paint(column, close_row, 'C');
+        paint(column, open_row, 'O');
+        paint(column, low_row, '*');
+        paint(column, high_row, '*');
+    }
+
+    std::string frame;
+    frame.reserve(rows * (width + 10) + 5 + width + 1);
+    char label[64];
+    for (size_t r = 0; r < rows; ++r) {
+        int row = height - static_cast<int>(r);
+        double temp = global_low + (row * range / height);
+        int length = std::snprintf(label, sizeof(label), "%5.1f | ", temp);
+        frame.append(label, static_cast<size_t>(std::max(length, 0)));
+        frame.append(grid, r * width, width);
+        frame += '\n';
+    }
+
+    // Date labels, right-aligned in each cell
+    frame += "     ";
+    for (const auto& candle : candlesticks) {
+        if (candle.date.size() < kCellWidth) {
+            frame.append(kCellWidth - candle.date.size(), ' ');
+        }
+        frame += candle.date;
+    }
+    frame += '\n';
+    return frame;
+}
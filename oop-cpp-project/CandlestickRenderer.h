@@ -0,0 +1,57 @@
+#ifndef CANDLESTICK_RENDERER_H
+#define CANDLESTICK_RENDERER_H
+
+#include "Candlestick.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief A line drawn over a candlestick chart, one value per candle (NaN skips a candle).
+ */
+struct PlotOverlay {
+    std::vector<double> values;
+    char glyph;
+};
+
+/**
+ * @brief Rasterises a candlestick chart into a text frame.
+ *
+ * Each candle's high, low, open and close rows are computed once as integers.
+ * The glyphs are then painted column by column into a character grid, and the
+ * y-axis labels and date footer are added around it. This costs one
+ * floating-point pass over the candles plus a memset-sized fill, instead of
+ * recomputing positions for every cell. The caller writes the whole frame at
+ * once.
+ *
+ * The output is byte-for-byte what the original per-cell plot printed: one row
+ * per temperature level with a "%5.1f | " label, seven columns per candle
+ * ('*' high/low, 'O' open, 'C' close, '|' body), and the dates right-aligned
+ * in seven columns underneath.
+ *
+ * Overlays (moving averages, bands) are painted first as a line running from
+ * each candle's column to the next one's, so candle glyphs stay on top. With
+ * overlays, the temperature axis also spans their values.
+ */
+class CandlestickRenderer {
+public:
+    /**
+     * @param plot_height Upper bound on the number of rows; the chart uses
+     *                    min(plot_height, 2 * temperature range), but at least 10.
+     */
+    explicit CandlestickRenderer(int plot_height = 20);
+
+    /**
+     * @brief Renders the chart for a series. An empty series renders a notice.
+     *
+     * @param candlesticks The candles, left to right.
+     * @param overlays Lines to draw behind the candles, each aligned with candlesticks.
+     */
+    std::string render(const std::vector<Candlestick>& candlesticks,
+                       const std::vector<PlotOverlay>& overlays = {}) const;
+
+private:
+    int plot_height_;
+};
+
+#endif // CANDLESTICK_RENDERER_H
@@ -0,0 +1,243 @@
+#include "ColumnAggregation.h"
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Statistics of one run of consecutive readings that share a bucket.
+ */
+struct RunningStats {
+    uint64_t count = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double sum = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    int64_t open_time = 0;
+    int64_t close_time = 0;
+
+    /**
+     * Open and close follow the timestamps; ties keep the first and last reading added.
+     */
+    void add(double value, int64_t time) {
+        if (count == 0) {
+            open = high = low = value;
+            open_time = time;
+        } else {
+            high = std::max(high, value);
+            low = std::min(low, value);
+            if (time < open_time) {
+                open = value;
+                open_time = time;
+            }
+        }
+        if (count == 0 || time >= close_time) {
+            close = value;
+            close_time = time;
+        }
+        sum += value;
+
+        // Welford: numerically stable running mean and sum of squared deviations
+        ++count;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+};
+
+/**
+ * Open and close timestamps of every slot, kept only for out-of-order input.
+ */
+struct SlotTimes {
+    std::vector<int64_t> open_time;
+    std::vector<int64_t> close_time;
+};
+
+/**
+ * Stores a finished run in its slot. A bucket whose rows are not contiguous
+ * (out-of-order input) receives several runs; their open and close are merged
+ * by timestamp through times, which is only sized for such input.
+ */
+void storeRun(ColumnAggregates& result, size_t slot, const RunningStats& run, SlotTimes& times) {
+    const bool timed = !times.open_time.empty();
+    if (result.count[slot] == 0) {
+        if (timed) {
+            times.open_time[slot] = run.open_time;
+            times.close_time[slot] = run.close_time;
+        }
+        result.count[slot] = run.count;
+        result.open[slot] = run.open;
+        result.high[slot] = run.high;
+        result.low[slot] = run.low;
+        result.close[slot] = run.close;
+        result.sum[slot] = run.sum;
+        result.mean[slot] = run.mean;
+        result.m2[slot] = run.m2;
+        return;
+    }
+
+    // Chan et al.'s pairwise combination of mean and M2
+    double n_a = static_cast<double>(result.count[slot]);
+    double n_b = static_cast<double>(run.count);
+    double delta = run.mean - result.mean[slot];
+    result.mean[slot] += delta * n_b / (n_a + n_b);
+    result.m2[slot] += run.m2 + delta * delta * n_a * n_b / (n_a + n_b);
+
+    result.count[slot] += run.count;
+    result.high[slot] = std::max(result.high[slot], run.high);
+    result.low[slot] = std::min(result.low[slot], run.low);
+    if (run.open_time < times.open_time[slot]) {
+        result.open[slot] = run.open;
+        times.open_time[slot] = run.open_time;
+    }
+    if (run.close_time >= times.close_time[slot]) {
+        result.close[slot] = run.close;
+        times.close_time[slot] = run.close_time;
+    }
+    result.sum[slot] += run.sum;
+}
+
+} // namespace
+
+// --- ColumnAggregates ---
+
+double ColumnAggregates::variance(size_t column, size_t bucket) const {
+    size_t slot = index(column, bucket);
+    if (count[slot] < 2) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return m2[slot] / static_cast<double>(count[slot] - 1);
+}
+
+int ColumnAggregates::findColumn(const std::string& name) const {
+    auto it = std::find(column_names.begin(), column_names.end(), name);
+    return it == column_names.end() ? -1 : static_cast<int>(it - column_names.begin());
+}
+
+Candlestick ColumnAggregates::candle(size_t column, size_t bucket) const {
+    size_t slot = index(column, bucket);
+    return Candlestick(labels[bucket], open[slot], high[slot], low[slot], close[slot], count[slot], sum[slot]);
+}
+
+// --- Aggregation ---
+
+/**
+ * Expands prefixes to every column that starts with "<prefix>_".
+ *
+ * @param table The parsed weather table.
+ * @param selectors Column names or country prefixes.
+ * @return The selected column names.
+ */
+std::vector<std::string> selectColumns(const WeatherTable& table, const std::vector<std::string>& selectors) {
+    if (selectors.empty()) {
+        return table.column_names;
+    }
+
+    std::vector<std::string> selected;
+    auto select = [&selected](const std::string& name) {
+        if (std::find(selected.begin(), selected.end(), name) == selected.end()) {
+            selected.push_back(name);
+        }
+    };
+
+    for (const auto& selector : selectors) {
+        if (table.findColumn(selector) != -1) {
+            select(selector);
+            continue;
+        }
+        bool matched = false;
+        for (const auto& name : table.column_names) {
+            if (name.size() > selector.size() + 1 && name.compare(0, selector.size(), selector) == 0 &&
+                name[selector.size()] == '_') {
+                select(name);
+                matched = true;
+            }
+        }
+        if (!matched) {
+            throw std::runtime_error("No column matches " + selector);
+        }
+    }
+    return selected;
+}
+
+/**
+ * Buckets the rows once, then makes one pass over each column's valid
+ * readings, flushing the running statistics whenever the bucket changes.
+ *
+ * @param table The parsed weather table.
+ * @param time_frame The bucket size.
+ * @param column_names The columns to aggregate; empty means all.
+ * @return The statistics of every column and bucket.
+ */
+ColumnAggregates aggregateColumns(const WeatherTable& table, const TimeFrameSpec& time_frame,
+                                  const std::vector<std::string>& column_names) {
+    ScopedTimer timer("aggregate");
+    ColumnAggregates result;
+    result.time_frame = time_frame;
+    result.column_names = column_names.empty() ? table.column_names : column_names;
+
+    std::vector<size_t> columns;
+    for (const auto& name : result.column_names) {
+        int column = table.findColumn(name);
+        if (column == -1) {
+            throw std::runtime_error("Column not found: " + name);
+        }
+        columns.push_back(static_cast<size_t>(column));
+    }
+    if (table.validity.size() != table.columns.size()) {
+        throw std::runtime_error("Validity bitmaps have not been built");
+    }
+
+    std::vector<uint32_t> row_bucket;
+    result.bucket_ids = assignTimeBuckets(table.timestamps, time_frame, row_bucket);
+    result.labels.reserve(result.bucket_ids.size());
+    for (int64_t id : result.bucket_ids) {
+        result.labels.push_back(timeBucketLabel(id, time_frame));
+    }
+
+    const size_t slots = result.columnCount() * result.bucketCount();
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    result.count.assign(slots, 0);
+    for (auto* metric : {&result.open, &result.high, &result.low, &result.close, &result.sum, &result.mean,
+                         &result.m2}) {
+        metric->assign(slots, missing);
+    }
+    Instrumentation::add(Counter::BucketsCreated, result.bucketCount());
+    Instrumentation::add(Counter::BytesAllocated, row_bucket.size() * sizeof(uint32_t) +
+                         slots * (sizeof(uint64_t) + 7 * sizeof(double)));
+
+    // Sorted rows give one run per slot; only unsorted ones need the slots' timestamps
+    SlotTimes times;
+    if (!std::is_sorted(table.timestamps.begin(), table.timestamps.end())) {
+        times.open_time.resize(slots);
+        times.close_time.resize(slots);
+    }
+
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const std::vector<double>& values = table.columns[columns[c]];
+        const size_t base = result.index(c, 0);
+
+        RunningStats run;
+        uint32_t run_bucket = 0;
+        table.validity[columns[c]].forEachValid(0, values.size(), [&](size_t i) {
+            if (run.count > 0 && row_bucket[i] != run_bucket) {
+                storeRun(result, base + run_bucket, run, times);
+                run = RunningStats();
+            }
+            run_bucket = row_bucket[i];
+            run.add(values[i], table.timestamps[i]);
+        });
+        if (run.count > 0) {
+            storeRun(result, base + run_bucket, run, times);
+        }
+    }
+
+    return result;
+}
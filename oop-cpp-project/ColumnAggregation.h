@@ -0,0 +1,90 @@
+#ifndef COLUMN_AGGREGATION_H
+#define COLUMN_AGGREGATION_H
+
+#include "Candlestick.h"
+#include "TimeFrame.h"
+#include "WeatherTable.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Per-bucket statistics of several columns, one array per metric.
+ *
+ * Every metric array is column-major: column c, bucket b is at index(c, b), so
+ * one column's series is contiguous. All columns share the same buckets.
+ * Buckets where a column has no valid reading have count 0 and NaN for every
+ * other metric of that column.
+ */
+struct ColumnAggregates {
+    TimeFrameSpec time_frame;
+    std::vector<int64_t> bucket_ids;       // Ascending.
+    std::vector<std::string> labels;       // timeBucketLabel of each bucket.
+    std::vector<std::string> column_names; // The aggregated columns, in request order.
+
+    std::vector<uint64_t> count;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> sum;
+    std::vector<double> mean;
+    std::vector<double> m2; // Sum of squared deviations from the mean (Welford).
+
+    size_t bucketCount() const { return bucket_ids.size(); }
+    size_t columnCount() const { return column_names.size(); }
+    size_t index(size_t column, size_t bucket) const { return column * bucketCount() + bucket; }
+
+    /**
+     * @brief Sample variance of a bucket; NaN with fewer than two readings.
+     */
+    double variance(size_t column, size_t bucket) const;
+
+    /**
+     * @brief Looks up an aggregated column by name.
+     *
+     * @return The column's position in column_names, or -1 if it was not aggregated.
+     */
+    int findColumn(const std::string& name) const;
+
+    /**
+     * @brief The OHLC part of one bucket as a Candlestick.
+     */
+    Candlestick candle(size_t column, size_t bucket) const;
+};
+
+/**
+ * @brief Expands column selectors into column names.
+ *
+ * A selector is either a full column name ("DE_radiation_direct_horizontal")
+ * or a country prefix ("DE"), which selects every column of that country.
+ * No selectors selects every numeric column.
+ *
+ * @param table The parsed weather table.
+ * @param selectors The selectors, in order.
+ * @return The column names, in selector order, without duplicates.
+ * @throws std::runtime_error if a selector matches no column.
+ */
+std::vector<std::string> selectColumns(const WeatherTable& table, const std::vector<std::string>& selectors);
+
+/**
+ * @brief Aggregates many columns into time buckets in one fused pass per column.
+ *
+ * Rows are bucketed once for all columns. Each valid reading is then read
+ * exactly once and updates open/high/low/close, count, sum, and Welford's
+ * running mean and M2 together. Consecutive readings of the same bucket are
+ * folded in registers and stored once per run. Missing readings are skipped
+ * through the validity bitmaps. Open and close are each bucket's earliest and
+ * latest readings by timestamp, as in computeCandlestickData.
+ *
+ * @param table The parsed weather table.
+ * @param time_frame The bucket size.
+ * @param column_names The columns to aggregate (see selectColumns); empty means all.
+ * @return The statistics of every column and bucket.
+ * @throws std::runtime_error if a column is unknown.
+ */
+ColumnAggregates aggregateColumns(const WeatherTable& table, const TimeFrameSpec& time_frame,
+                                  const std::vector<std::string>& column_names = {});
+
+#endif // COLUMN_AGGREGATION_H
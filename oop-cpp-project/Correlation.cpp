@@ -0,0 +1,328 @@
+#include "Correlation.h"
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const size_t kTileColumns = 4;  // Columns per tile; a task covers two tiles.
+const size_t kBlockRows = 1024; // Rows per block: 8 columns x 2 buffers x 8 KiB stay in L2.
+const size_t kLanes = 4;        // Independent accumulators per sum.
+
+/**
+ * Sums of one column pair over the rows where both hold a reading, with
+ * readings shifted by their column means.
+ */
+struct PairSums {
+    double n = 0.0;
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    double sum_xx = 0.0;
+    double sum_yy = 0.0;
+    double sum_xy = 0.0;
+};
+
+/**
+ * Runs job(i) for i in [0, count), handing indices to `threads` workers.
+ */
+template <typename Job>
+void forEachParallel(size_t count, size_t threads, Job job) {
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                job(i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Adds one block of a column pair to its totals. Missing readings are 0 in x
+ * and in the mask, so every row is a plain multiply-add; rows is a multiple
+ * of kLanes (the buffers are zero-padded).
+ */
+void accumulateBlock(const double* x, const double* x_mask, const double* y, const double* y_mask, size_t rows,
+                     PairSums& total) {
+    double n[kLanes] = {}, sum_x[kLanes] = {}, sum_y[kLanes] = {};
+    double sum_xx[kLanes] = {}, sum_yy[kLanes] = {}, sum_xy[kLanes] = {};
+    for (size_t r = 0; r < rows; r += kLanes) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            double xv = x[r + lane], yv = y[r + lane];
+            double xm = x_mask[r + lane], ym = y_mask[r + lane];
+            n[lane] += xm * ym;
+            sum_x[lane] += xv * ym;
+            sum_y[lane] += yv * xm;
+            sum_xx[lane] += xv * xv * ym;
+            sum_yy[lane] += yv * yv * xm;
+            sum_xy[lane] += xv * yv;
+        }
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        total.n += n[lane];
+        total.sum_x += sum_x[lane];
+        total.sum_y += sum_y[lane];
+        total.sum_xx += sum_xx[lane];
+        total.sum_yy += sum_yy[lane];
+        total.sum_xy += sum_xy[lane];
+    }
+}
+
+/**
+ * Mean of a column's readings, used only as a shift; 0 for an empty column.
+ */
+double columnMean(const std::vector<double>& values) {
+    double sum = 0.0;
+    size_t count = 0;
+    for (double value : values) {
+        if (!std::isnan(value)) {
+            sum += value;
+            ++count;
+        }
+    }
+    return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+
+} // namespace
+
+// --- Column selection ---
+
+/**
+ * Maps country prefixes to their temperature columns.
+ *
+ * @param table The parsed weather table.
+ * @param selectors Column names or country prefixes.
+ * @return The selected column names.
+ */
+std::vector<std::string> selectCorrelationColumns(const WeatherTable& table,
+                                                  const std::vector<std::string>& selectors) {
+    std::vector<std::string> selected;
+    auto select = [&selected](const std::string& name) {
+        if (std::find(selected.begin(), selected.end(), name) == selected.end()) {
+            selected.push_back(name);
+        }
+    };
+
+    if (selectors.empty()) {
+        for (const auto& prefix : table.countryPrefixes()) {
+            select(prefix + "_temperature");
+        }
+        return selected;
+    }
+
+    for (const auto& selector : selectors) {
+        if (table.findColumn(selector) != -1) {
+            select(selector);
+        } else if (table.findColumn(selector + "_temperature") != -1) {
+            select(selector + "_temperature");
+        } else {
+            throw std::runtime_error("No column matches " + selector);
+        }
+    }
+    return selected;
+}
+
+// --- Correlation ---
+
+/**
+ * Splits the upper triangle of column pairs into tile pairs and runs them in
+ * parallel; each task owns its pairs' slots, so no locking is needed.
+ *
+ * @param table The parsed weather table.
+ * @param column_names The columns to correlate.
+ * @param threads Worker threads; 0 uses all hardware threads.
+ * @return The matrices.
+ */
+CorrelationMatrix correlateColumns(const WeatherTable& table, const std::vector<std::string>& column_names,
+                                   unsigned threads) {
+    ScopedTimer timer("correlation");
+    const size_t count = column_names.size();
+    const size_t rows = table.timestamps.size();
+
+    std::vector<const std::vector<double>*> columns;
+    CorrelationMatrix result;
+    for (const auto& name : column_names) {
+        int column = table.findColumn(name);
+        if (column == -1) {
+            throw std::runtime_error("Column not found: " + name);
+        }
+        columns.push_back(&table.columns[static_cast<size_t>(column)]);
+
+        const std::string suffix = "_temperature";
+        bool temperature = name.size() > suffix.size() &&
+                           name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+        result.labels.push_back(temperature ? name.substr(0, name.size() - suffix.size()) : name);
+    }
+
+    std::vector<double> means(count);
+    for (size_t c = 0; c < count; ++c) {
+        means[c] = columnMean(*columns[c]);
+    }
+
+    std::vector<PairSums> sums(count * count);
+    const size_t tiles = (count + kTileColumns - 1) / kTileColumns;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t a = 0; a < tiles; ++a) {
+        for (size_t b = a; b < tiles; ++b) {
+            tasks.emplace_back(a, b);
+        }
+    }
+
+    size_t workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    forEachParallel(tasks.size(), workers, [&](size_t t) {
+        // The task's columns: tile a, then tile b if it is a different tile
+        std::vector<size_t> members;
+        for (size_t tile : {tasks[t].first, tasks[t].second}) {
+            for (size_t c = tile * kTileColumns; c < std::min(count, (tile + 1) * kTileColumns); ++c) {
+                if (std::find(members.begin(), members.end(), c) == members.end()) {
+                    members.push_back(c);
+                }
+            }
+        }
+        const size_t first_b = tasks[t].first == tasks[t].second ? 0 : std::min(kTileColumns, members.size());
+
+        std::vector<double> values(members.size() * kBlockRows);
+        std::vector<double> masks(members.size() * kBlockRows);
+        for (size_t start = 0; start < rows; start += kBlockRows) {
+            const size_t block = std::min(kBlockRows, rows - start);
+            const size_t padded = (block + kLanes - 1) / kLanes * kLanes;
+
+            for (size_t m = 0; m < members.size(); ++m) {
+                const double* source = columns[members[m]]->data() + start;
+                double* value = &values[m * kBlockRows];
+                double* mask = &masks[m * kBlockRows];
+                for (size_t r = 0; r < block; ++r) {
+                    bool present = !std::isnan(source[r]);
+                    value[r] = present ? source[r] - means[members[m]] : 0.0;
+                    mask[r] = present ? 1.0 : 0.0;
+                }
+                std::fill(value + block, value + padded, 0.0);
+                std::fill(mask + block, mask + padded, 0.0);
+            }
+
+            // Pairs within the tile (upper triangle), or every tile a x tile b pair
+            for (size_t i = 0; i < members.size(); ++i) {
+                size_t j_first = first_b == 0 ? i : std::max(first_b, i + 1);
+                if (first_b != 0 && i >= first_b) {
+                    break;
+                }
+                for (size_t j = j_first; j < members.size(); ++j) {
+                    accumulateBlock(&values[i * kBlockRows], &masks[i * kBlockRows], &values[j * kBlockRows],
+                                    &masks[j * kBlockRows], padded, sums[members[i] * count + members[j]]);
+                }
+            }
+        }
+    });
+
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    result.correlation.assign(count * count, missing);
+    result.covariance.assign(count * count, missing);
+    result.pairs.assign(count * count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = i; j < count; ++j) {
+            const PairSums& s = sums[i * count + j];
+            uint64_t pairs = static_cast<uint64_t>(s.n + 0.5);
+            result.pairs[result.index(i, j)] = result.pairs[result.index(j, i)] = pairs;
+            if (pairs < 2) {
+                continue;
+            }
+
+            // Centred sums over the paired rows; the mean shift cancels out
+            double co = s.sum_xy - s.sum_x * s.sum_y / s.n;
+            double xx = std::max(s.sum_xx - s.sum_x * s.sum_x / s.n, 0.0);
+            double yy = std::max(s.sum_yy - s.sum_y * s.sum_y / s.n, 0.0);
+            double covariance = co / (s.n - 1.0);
+            result.covariance[result.index(i, j)] = result.covariance[result.index(j, i)] = covariance;
+            if (xx > 0.0 && yy > 0.0) {
+                double correlation = std::clamp(co / std::sqrt(xx * yy), -1.0, 1.0);
+                result.correlation[result.index(i, j)] = result.correlation[result.index(j, i)] = correlation;
+            }
+        }
+    }
+    return result;
+}
+
+// --- Heatmap ---
+
+/**
+ * Labels the rows on the left and the columns along the top, then shades one
+ * cell per pair.
+ *
+ * @param matrix The matrix to draw.
+ * @return The heatmap text.
+ */
+std::string renderCorrelationHeatmap(const CorrelationMatrix& matrix) {
+    static const char kShades[] = " .:;+=xX#@";
+    const size_t count = matrix.size();
+    if (count == 0) {
+        return "No columns to correlate.\n";
+    }
+
+    bool numbered = false;
+    size_t label_width = 0;
+    for (const auto& label : matrix.labels) {
+        numbered = numbered || label.size() > 2;
+        label_width = std::max(label_width, label.size());
+    }
+
+    char number[16];
+    auto rowLabel = [&](size_t row) {
+        std::string text;
+        if (numbered) {
+            std::snprintf(number, sizeof(number), "%2zu ", (row + 1) % 100);
+            text = number;
+        }
+        text += matrix.labels[row];
+        text.append(label_width - matrix.labels[row].size(), ' ');
+        return text;
+    };
+
+    std::string frame(rowLabel(0).size() + 2, ' ');
+    for (size_t column = 0; column < count; ++column) {
+        if (numbered) {
+            std::snprintf(number, sizeof(number), "%3zu", (column + 1) % 100);
+            frame += number;
+        } else {
+            frame.append(3 - matrix.labels[column].size(), ' ');
+            frame += matrix.labels[column];
+        }
+    }
+    frame += '\n';
+
+    for (size_t row = 0; row < count; ++row) {
+        frame += rowLabel(row);
+        frame += " |";
+        for (size_t column = 0; column < count; ++column) {
+            double value = matrix.correlation[matrix.index(row, column)];
+            if (std::isnan(value)) {
+                frame += " ??";
+                continue;
+            }
+            char shade = kShades[std::min<size_t>(9, static_cast<size_t>(std::abs(value) * 10))];
+            frame += value < 0 ? '-' : ' ';
+            frame += shade;
+            frame += shade;
+        }
+        frame += '\n';
+    }
+    frame += "Scale: |r| 0 ' ' . : ; + = x X # @ 1; '-' negative, '\?\?' undefined\n";
+    return frame;
+}
@@ -0,0 +1,77 @@
+#ifndef CORRELATION_H
+#define CORRELATION_H
+
+#include "WeatherTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Pairwise Pearson correlation and covariance of several columns.
+ *
+ * Missing readings are handled pairwise: each pair uses exactly the rows where
+ * both columns hold a reading, with the means of those rows. Two series that
+ * were recorded over different decades are therefore compared over their
+ * overlap only. Every matrix is symmetric, n x n and row-major.
+ */
+struct CorrelationMatrix {
+    std::vector<std::string> labels;  // One per column, e.g. "DE" for DE_temperature.
+    std::vector<double> correlation;  // NaN with fewer than two paired rows or a constant series.
+    std::vector<double> covariance;   // Sample covariance; NaN with fewer than two paired rows.
+    std::vector<uint64_t> pairs;      // Number of rows where both columns hold a reading.
+
+    size_t size() const { return labels.size(); }
+    size_t index(size_t row, size_t column) const { return row * size() + column; }
+};
+
+/**
+ * @brief Expands correlation selectors into column names.
+ *
+ * A selector is either a full column name or a country prefix, which selects
+ * that country's temperature column. No selectors selects every country.
+ *
+ * @param table The parsed weather table.
+ * @param selectors The selectors, in order.
+ * @return The column names, in selector order, without duplicates.
+ * @throws std::runtime_error if a selector matches no column.
+ */
+std::vector<std::string> selectCorrelationColumns(const WeatherTable& table,
+                                                  const std::vector<std::string>& selectors);
+
+/**
+ * @brief Correlates every pair of columns over the hourly rows, in parallel.
+ *
+ * Columns are split into tiles and each pair of tiles is one task. A task
+ * walks the rows in cache-sized blocks; for each block it copies its columns
+ * once into dense buffers (readings shifted by the column mean, missing
+ * readings as 0 with a 0/1 mask) and then runs a branch-free multiply-add
+ * kernel for every column pair in the tile. The kernel keeps four independent
+ * accumulators per sum so the compiler can vectorise it without relaxing
+ * floating-point semantics. Block sums are added into the totals, which also
+ * limits rounding error over long series.
+ *
+ * @param table The parsed weather table.
+ * @param column_names The columns to correlate.
+ * @param threads Worker threads; 0 uses all hardware threads.
+ * @return The correlation, covariance and pair counts.
+ * @throws std::runtime_error if a column is unknown.
+ */
+CorrelationMatrix correlateColumns(const WeatherTable& table, const std::vector<std::string>& column_names,
+                                   unsigned threads = 0);
+
+/**
+ * @brief Draws the correlation matrix as a text heatmap.
+ *
+ * One three-character cell per pair: the shade is repeated twice, from ' '
+ * (0) through ".:;+=xX#" to '@' (1). A leading '-' marks a negative
+ * correlation and "??" an undefined one. Columns are headed by their labels,
+ * or by their row numbers when a label is longer than two characters.
+ *
+ * @param matrix The matrix to draw.
+ * @return The heatmap and a one-line legend, newline-terminated.
+ */
+std::string renderCorrelationHeatmap(const CorrelationMatrix& matrix);
+
+#endif // CORRELATION_H
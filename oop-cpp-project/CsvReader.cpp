@@ -0,0 +1,265 @@
+#include "CsvReader.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// --- MappedFile ---
+
+/**
+ * Maps the whole file read-only. On failure the object is left closed.
+ *
+ * @param filename The path of the file to map.
+ */
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (view == MAP_FAILED) {
+        return;
+    }
+    ::madvise(view, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<std::size_t>(st.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        file_handle_ = std::exchange(other.file_handle_, nullptr);
+        mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+/**
+ * Unmaps the file and closes any handles still held.
+ */
+void MappedFile::release() {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(mapping_handle_);
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(file_handle_);
+    }
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// --- CsvReader ---
+
+/**
+ * Opens and maps a CSV file. Use isOpen() to check for failure.
+ *
+ * @param filename The name of the CSV file.
+ * @param delimiter The cell delimiter.
+ */
+CsvReader::CsvReader(const std::string& filename, char delimiter)
+    : file_(filename), delimiter_(delimiter) {}
+
+/**
+ * Collects every non-empty line of the mapping.
+ *
+ * @return Views of each line, without line endings.
+ */
+std::vector<std::string_view> CsvReader::lines() const {
+    std::vector<std::string_view> result;
+    std::string_view text = contents();
+    std::size_t offset = 0;
+
+    while (offset < text.size()) {
+        std::string_view line = nextLine(text, offset);
+        if (!line.empty()) {
+            result.push_back(line);
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the line starting at offset and moves offset to the start of the next one.
+ *
+ * @param text The full text being scanned.
+ * @param offset The current position; updated to just past the newline.
+ * @return The line without its '\n' or "\r\n" terminator.
+ */
+std::string_view CsvReader::nextLine(std::string_view text, std::size_t& offset) {
+    std::size_t end = text.find('\n', offset);
+    if (end == std::string_view::npos) {
+        end = text.size();
+    }
+
+    std::string_view line = text.substr(offset, end - offset);
+    offset = end + 1;
+
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+/**
+ * Splits a line on the delimiter. Empty cells are kept so column indices
+ * always line up with the header.
+ *
+ * @param line The line to split.
+ * @param cells Output vector; cleared and refilled.
+ * @param delimiter The cell delimiter.
+ */
+void CsvReader::splitRow(std::string_view line, std::vector<std::string_view>& cells, char delimiter) {
+    cells.clear();
+    std::size_t start = 0;
+
+    while (true) {
+        std::size_t end = line.find(delimiter, start);
+        if (end == std::string_view::npos) {
+            cells.push_back(line.substr(start));
+            break;
+        }
+        cells.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+// --- CsvStreamReader ---
+
+/**
+ * Opens the file for buffered reading. Use isOpen() to check for failure.
+ *
+ * @param filename The name of the CSV file.
+ * @param delimiter The cell delimiter.
+ * @param window_bytes The size of the read buffer.
+ */
+CsvStreamReader::CsvStreamReader(const std::string& filename, char delimiter, std::size_t window_bytes)
+    : file_(filename, std::ios::binary), delimiter_(delimiter), window_(std::max<std::size_t>(window_bytes, 64)) {}
+
+/**
+ * Returns the next non-empty line, refilling the window whenever no complete
+ * line is left in it. The last line need not end with a newline.
+ *
+ * @param cells Output vector; cleared and refilled.
+ * @return False at the end of the file.
+ */
+bool CsvStreamReader::nextRow(std::vector<std::string_view>& cells) {
+    while (true) {
+        std::string_view unread(window_.data() + offset_, filled_ - offset_);
+        std::size_t newline = unread.find('\n');
+        if (newline == std::string_view::npos && !end_of_file_) {
+            refill();
+            continue;
+        }
+        if (unread.empty()) {
+            return false;
+        }
+
+        std::size_t offset = 0;
+        std::string_view line = CsvReader::nextLine(unread, offset);
+        offset_ += std::min(offset, unread.size());
+        if (!line.empty()) {
+            CsvReader::splitRow(line, cells, delimiter_);
+            return true;
+        }
+    }
+}
+
+/**
+ * Moves the unread bytes to the front of the window and reads more after them.
+ * The window doubles if a single line fills it.
+ *
+ * @return False once the file is exhausted.
+ */
+bool CsvStreamReader::refill() {
+    const std::size_t unread = filled_ - offset_;
+    if (unread > 0 && offset_ > 0) {
+        std::memmove(window_.data(), window_.data() + offset_, unread);
+    }
+    offset_ = 0;
+    filled_ = unread;
+    if (filled_ == window_.size()) {
+        window_.resize(window_.size() * 2);
+    }
+
+    file_.read(window_.data() + filled_, static_cast<std::streamsize>(window_.size() - filled_));
+    const std::size_t count = static_cast<std::size_t>(file_.gcount());
+    filled_ += count;
+    end_of_file_ = count == 0;
+    return !end_of_file_;
+}
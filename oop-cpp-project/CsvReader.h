@@ -0,0 +1,171 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapping is released when the object is destroyed. An empty or missing
+ * file yields an object whose isOpen() returns false.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps the given file into memory.
+     *
+     * @param filename The path of the file to map.
+     */
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool isOpen() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::string_view contents() const { return {data_, size_}; }
+
+private:
+    void release();
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+/**
+ * @brief Zero-copy CSV reader over a memory-mapped file.
+ *
+ * Rows and cells are exposed as std::string_view into the mapping, so no
+ * per-cell allocation takes place. Views stay valid for as long as the
+ * reader is alive. Quoted fields are not supported, matching readCSV.
+ */
+class CsvReader {
+public:
+    /**
+     * @brief Opens and maps a CSV file.
+     *
+     * @param filename The name of the CSV file to read.
+     * @param delimiter The cell delimiter.
+     */
+    explicit CsvReader(const std::string& filename, char delimiter = ',');
+
+    bool isOpen() const { return file_.isOpen(); }
+    std::string_view contents() const { return file_.contents(); }
+    char delimiter() const { return delimiter_; }
+
+    /**
+     * @brief Calls the callback once per non-empty line, in file order.
+     *
+     * The callback receives the zero-based row index and the cells of that
+     * row. The cell vector is reused between calls and must not be kept.
+     *
+     * @param callback Invocable as callback(size_t, const std::vector<std::string_view>&).
+     *                 Returning false from it stops the iteration early.
+     */
+    template <typename Callback>
+    void forEachRow(Callback&& callback) const;
+
+    /**
+     * @brief Returns every non-empty line of the file (without line endings).
+     */
+    std::vector<std::string_view> lines() const;
+
+    /**
+     * @brief Returns the next line starting at offset and advances offset past it.
+     *
+     * Trailing '\r' is stripped so files with Windows line endings behave the
+     * same on every platform.
+     */
+    static std::string_view nextLine(std::string_view text, std::size_t& offset);
+
+    /**
+     * @brief Splits a single line into cells, reusing the given vector.
+     */
+    static void splitRow(std::string_view line, std::vector<std::string_view>& cells, char delimiter = ',');
+
+private:
+    MappedFile file_;
+    char delimiter_;
+};
+
+/**
+ * @brief CSV reader that reads the file through a fixed-size window.
+ *
+ * Unlike CsvReader, nothing is mapped: bytes are read into one buffer that is
+ * refilled as rows are consumed, so memory use stays at the window size (or
+ * the longest line, if that is larger) however big the file is. Rows are
+ * returned one at a time, with the same line and cell rules as CsvReader.
+ */
+class CsvStreamReader {
+public:
+    /**
+     * @brief Opens a CSV file for streaming.
+     *
+     * @param filename The name of the CSV file to read.
+     * @param delimiter The cell delimiter.
+     * @param window_bytes The size of the read buffer.
+     */
+    explicit CsvStreamReader(const std::string& filename, char delimiter = ',',
+                             std::size_t window_bytes = 1 << 20);
+
+    bool isOpen() const { return file_.is_open(); }
+
+    /**
+     * @brief Reads the next non-empty line and splits it into cells.
+     *
+     * The cells point into the window and are valid until the next call.
+     *
+     * @param cells Output vector; cleared and refilled.
+     * @return False at the end of the file.
+     */
+    bool nextRow(std::vector<std::string_view>& cells);
+
+private:
+    bool refill();
+
+    std::ifstream file_;
+    char delimiter_;
+    std::vector<char> window_;
+    std::size_t offset_ = 0; // Start of the unread bytes in window_.
+    std::size_t filled_ = 0; // End of the bytes read into window_.
+    bool end_of_file_ = false;
+};
+
+template <typename Callback>
+void CsvReader::forEachRow(Callback&& callback) const {
+    std::string_view text = contents();
+    std::vector<std::string_view> cells;
+    std::size_t offset = 0;
+    std::size_t row_index = 0;
+
+    while (offset < text.size()) {
+        std::string_view line = nextLine(text, offset);
+        if (line.empty()) {
+            continue;
+        }
+        splitRow(line, cells, delimiter_);
+        if constexpr (std::is_same_v<decltype(callback(row_index, cells)), bool>) {
+            if (!callback(row_index, cells)) {
+                return;
+            }
+        } else {
+            callback(row_index, cells);
+        }
+        ++row_index;
+    }
+}
+
+#endif // CSV_READER_H
@@ -0,0 +1,81 @@
+#include "DateTime.h"
+
+#include <cstdio>
+
+namespace {
+
+/**
+ * Reads a fixed-width run of digits.
+ *
+ * @return The number, or -1 if any character is not a digit.
+ */
+int readDigits(std::string_view text, size_t pos, size_t count) {
+    if (pos + count > text.size()) {
+        return -1;
+    }
+    int value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        char c = text[i];
+        if (c < '0' || c > '9') {
+            return -1;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+} // namespace
+
+/**
+ * Parses "YYYY-MM-DD" optionally followed by "THH:MM:SS" (or a space
+ * separator), ignoring any trailing zone designator.
+ *
+ * @param text The timestamp text.
+ * @param epoch_seconds Receives seconds since the Unix epoch.
+ * @return True on success.
+ */
+bool parseTimestamp(std::string_view text, int64_t& epoch_seconds) {
+    if (text.size() < 10 || text[4] != '-' || text[7] != '-') {
+        return false;
+    }
+
+    int year = readDigits(text, 0, 4);
+    int month = readDigits(text, 5, 2);
+    int day = readDigits(text, 8, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+
+    int hour = 0, minute = 0, second = 0;
+    if (text.size() >= 19 && (text[10] == 'T' || text[10] == ' ')) {
+        hour = readDigits(text, 11, 2);
+        minute = readDigits(text, 14, 2);
+        second = readDigits(text, 17, 2);
+        if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+            return false;
+        }
+    }
+
+    epoch_seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+/**
+ * Formats epoch seconds in the same layout as the dataset's utc_timestamp column.
+ *
+ * @param epoch_seconds Seconds since the Unix epoch.
+ * @return The formatted timestamp.
+ */
+std::string formatTimestamp(int64_t epoch_seconds) {
+    const int64_t days = floorDiv(epoch_seconds, 86400);
+    const int64_t seconds_of_day = epoch_seconds - days * 86400;
+    CivilTime civil = civilFromDays(days);
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02dZ",
+                  civil.year, civil.month, civil.day,
+                  static_cast<int>(seconds_of_day / 3600),
+                  static_cast<int>(seconds_of_day / 60 % 60),
+                  static_cast<int>(seconds_of_day % 60));
+    return buffer;
+}
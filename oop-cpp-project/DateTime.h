@@ -0,0 +1,82 @@
+#ifndef DATE_TIME_H
+#define DATE_TIME_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Calendar fields of a UTC timestamp.
+ */
+struct CivilTime {
+    int year;
+    int month;  // 1-12
+    int day;    // 1-31
+    int hour;   // 0-23
+};
+
+/**
+ * @brief Converts a calendar date to days since 1970-01-01.
+ *
+ * Uses the proleptic Gregorian calendar, valid for any year.
+ */
+constexpr int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;
+    const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Converts days since 1970-01-01 back to a calendar date.
+ */
+constexpr CivilTime civilFromDays(int64_t days) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const int year = static_cast<int>(yoe + era * 400 + (month <= 2));
+    return {year, month, day, 0};
+}
+
+/**
+ * @brief Floor division that rounds towards negative infinity.
+ */
+constexpr int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+/**
+ * @brief Splits epoch seconds into calendar fields.
+ */
+constexpr CivilTime civilFromEpoch(int64_t epoch_seconds) {
+    const int64_t days = floorDiv(epoch_seconds, 86400);
+    CivilTime civil = civilFromDays(days);
+    civil.hour = static_cast<int>((epoch_seconds - days * 86400) / 3600);
+    return civil;
+}
+
+/**
+ * @brief Parses an ISO-8601 UTC timestamp such as "2003-06-15T13:00:00Z".
+ *
+ * Only the date and the hour/minute/second fields are read; a trailing "Z"
+ * or offset is ignored. Date-only strings ("2003-06-15") are accepted.
+ *
+ * @param text The timestamp text.
+ * @param epoch_seconds Receives seconds since 1970-01-01T00:00:00Z.
+ * @return True if the text was a valid timestamp.
+ */
+bool parseTimestamp(std::string_view text, int64_t& epoch_seconds);
+
+/**
+ * @brief Formats epoch seconds as "YYYY-MM-DDTHH:MM:SSZ".
+ */
+std::string formatTimestamp(int64_t epoch_seconds);
+
+#endif // DATE_TIME_H
@@ -0,0 +1,186 @@
+#include "Decimation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// --- CandleDecimator ---
+
+CandleDecimator::CandleDecimator(size_t bucket_size, CandleCallback on_candle)
+    : bucket_size_(std::max<size_t>(bucket_size, 1)),
+      on_candle_(std::move(on_candle)),
+      current_("", 0, 0, 0, 0) {}
+
+/**
+ * Merges the next candle into the current run, emitting the run when full.
+ *
+ * @param candle The next candle, in time order.
+ */
+void CandleDecimator::add(const Candlestick& candle) {
+    if (filled_ == 0) {
+        current_ = candle;
+    } else {
+        current_.high = std::max(current_.high, candle.high);
+        current_.low = std::min(current_.low, candle.low);
+        current_.close = candle.close;
+        current_.count += candle.count;
+        current_.sum += candle.sum;
+    }
+
+    if (++filled_ == bucket_size_) {
+        finish();
+    }
+}
+
+void CandleDecimator::finish() {
+    if (filled_ > 0) {
+        on_candle_(current_);
+        filled_ = 0;
+    }
+}
+
+/**
+ * Merges runs of ceil(n / max_candles) candles.
+ *
+ * @param candlesticks The series, in time order.
+ * @param max_candles The largest number of candles to return.
+ * @return The decimated series.
+ */
+std::vector<Candlestick> decimateCandles(const std::vector<Candlestick>& candlesticks, size_t max_candles) {
+    if (max_candles == 0 || candlesticks.size() <= max_candles) {
+        return candlesticks;
+    }
+
+    std::vector<Candlestick> result;
+    size_t bucket_size = (candlesticks.size() + max_candles - 1) / max_candles;
+    result.reserve(max_candles);
+
+    CandleDecimator decimator(bucket_size, [&result](const Candlestick& candle) { result.push_back(candle); });
+    for (const auto& candle : candlesticks) {
+        decimator.add(candle);
+    }
+    decimator.finish();
+    return result;
+}
+
+/**
+ * Keeps the last value of each run of ceil(n / max_points) values.
+ *
+ * @param values The line, one value per candle.
+ * @param max_points The largest number of values to return.
+ * @return The decimated line.
+ */
+std::vector<double> decimateSeries(const std::vector<double>& values, size_t max_points) {
+    if (max_points == 0 || values.size() <= max_points) {
+        return values;
+    }
+
+    size_t bucket_size = (values.size() + max_points - 1) / max_points;
+    std::vector<double> result;
+    result.reserve(max_points);
+    for (size_t end = bucket_size; end < values.size() + bucket_size; end += bucket_size) {
+        result.push_back(values[std::min(end, values.size()) - 1]);
+    }
+    return result;
+}
+
+// --- LTTB ---
+
+/**
+ * Largest-Triangle-Three-Buckets over n points.
+ *
+ * @param x The x-coordinates, ascending.
+ * @param y The y-coordinates.
+ * @param threshold The number of points to keep.
+ * @return Indices of the kept points.
+ */
+std::vector<size_t> lttbIndices(const std::vector<double>& x, const std::vector<double>& y, size_t threshold) {
+    const size_t n = std::min(x.size(), y.size());
+    std::vector<size_t> kept;
+    if (threshold >= n || n <= 2) {
+        for (size_t i = 0; i < n; ++i) {
+            kept.push_back(i);
+        }
+        return kept;
+    }
+    if (threshold < 2) {
+        kept.push_back(0);
+        return kept;
+    }
+
+    kept.reserve(threshold);
+    kept.push_back(0);
+
+    // The interior points are split into threshold - 2 buckets.
+    const double bucket_width = static_cast<double>(n - 2) / static_cast<double>(threshold - 2);
+    size_t previous = 0;
+    for (size_t bucket = 0; bucket + 2 < threshold; ++bucket) {
+        size_t begin = 1 + static_cast<size_t>(std::floor(bucket * bucket_width));
+        size_t end = 1 + static_cast<size_t>(std::floor((bucket + 1) * bucket_width));
+        end = std::min(end, n - 1);
+
+        // Average of the next bucket (the last point for the final bucket)
+        size_t next_begin = end;
+        size_t next_end = std::min(1 + static_cast<size_t>(std::floor((bucket + 2) * bucket_width)), n - 1);
+        double average_x = 0.0, average_y = 0.0;
+        if (next_begin >= next_end) {
+            average_x = x[n - 1];
+            average_y = y[n - 1];
+        } else {
+            for (size_t i = next_begin; i < next_end; ++i) {
+                average_x += x[i];
+                average_y += y[i];
+            }
+            average_x /= static_cast<double>(next_end - next_begin);
+            average_y /= static_cast<double>(next_end - next_begin);
+        }
+
+        size_t best = begin;
+        double best_area = -1.0;
+        for (size_t i = begin; i < end; ++i) {
+            double area = std::fabs((x[previous] - average_x) * (y[i] - y[previous]) -
+                                    (x[previous] - x[i]) * (average_y - y[previous]));
+            if (area > best_area) {
+                best_area = area;
+                best = i;
+            }
+        }
+        kept.push_back(best);
+        previous = best;
+    }
+
+    kept.push_back(n - 1);
+    return kept;
+}
+
+// --- Terminal size ---
+
+size_t terminalColumns() {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return static_cast<size_t>(info.srWindow.Right - info.srWindow.Left + 1);
+    }
+#else
+    winsize size{};
+    if (isatty(STDOUT_FILENO) && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+#endif
+    if (const char* columns = std::getenv("COLUMNS")) {
+        long value = std::strtol(columns, nullptr, 10);
+        if (value > 0) {
+            return static_cast<size_t>(value);
+        }
+    }
+    return 80;
+}
@@ -0,0 +1,75 @@
+#ifndef DECIMATION_H
+#define DECIMATION_H
+
+#include "Candlestick.h"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Streaming min/max decimator for candle series.
+ *
+ * Consecutive runs of `bucket_size` candles are merged into one candle:
+ * first open, highest high, lowest low, last close, with count and sum added.
+ * Every extreme of the input therefore survives in the output. Each merged
+ * candle carries the date of the first candle in its run. O(1) memory; the
+ * callback sees each merged candle as soon as its run is complete.
+ */
+class CandleDecimator {
+public:
+    using CandleCallback = std::function<void(const Candlestick&)>;
+
+    CandleDecimator(size_t bucket_size, CandleCallback on_candle);
+
+    void add(const Candlestick& candle);
+
+    /**
+     * @brief Emits the last, possibly partial, run.
+     */
+    void finish();
+
+private:
+    size_t bucket_size_;
+    CandleCallback on_candle_;
+    Candlestick current_;
+    size_t filled_ = 0;
+};
+
+/**
+ * @brief Reduces a series to at most max_candles candles with min/max decimation.
+ *
+ * Series that already fit are returned unchanged. O(n).
+ */
+std::vector<Candlestick> decimateCandles(const std::vector<Candlestick>& candlesticks, size_t max_candles);
+
+/**
+ * @brief Reduces a line aligned with a candle series the way decimateCandles reduces the candles.
+ *
+ * Each run keeps its last value, as a merged candle keeps its last close.
+ */
+std::vector<double> decimateSeries(const std::vector<double>& values, size_t max_points);
+
+/**
+ * @brief Picks the points of a line to keep with Largest-Triangle-Three-Buckets.
+ *
+ * The first and last points are always kept. From each bucket in between, LTTB
+ * keeps the point that forms the largest triangle with the previously kept
+ * point and the average of the next bucket. This preserves peaks and the
+ * overall shape better than striding. O(n).
+ *
+ * @param x The x-coordinates, ascending.
+ * @param y The y-coordinates.
+ * @param threshold The number of points to keep.
+ * @return Indices of the kept points, ascending; all indices if threshold >= n.
+ */
+std::vector<size_t> lttbIndices(const std::vector<double>& x, const std::vector<double>& y, size_t threshold);
+
+/**
+ * @brief Width of the terminal standard output is attached to.
+ *
+ * Falls back to $COLUMNS, then to 80, when stdout is not a terminal.
+ */
+size_t terminalColumns();
+
+#endif // DECIMATION_H
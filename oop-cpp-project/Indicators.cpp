@@ -0,0 +1,278 @@
+#include "Indicators.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const double kMissing = std::numeric_limits<double>::quiet_NaN();
+
+} // namespace
+
+// --- SimpleMovingAverage ---
+
+SimpleMovingAverage::SimpleMovingAverage(size_t period) : period_(std::max<size_t>(period, 1)) {}
+
+double SimpleMovingAverage::add(double value) {
+    window_.push_back(value);
+    sum_ += value;
+    if (window_.size() > period_) {
+        sum_ -= window_.front();
+        window_.pop_front();
+    }
+    return window_.size() == period_ ? sum_ / static_cast<double>(period_) : kMissing;
+}
+
+// --- ExponentialMovingAverage ---
+
+ExponentialMovingAverage::ExponentialMovingAverage(size_t period)
+    : period_(std::max<size_t>(period, 1)), alpha_(2.0 / (static_cast<double>(period_) + 1.0)) {}
+
+double ExponentialMovingAverage::add(double value) {
+    ++seen_;
+    if (seen_ <= period_) {
+        value_ += value; // Sum of the seed window
+        if (seen_ < period_) {
+            return kMissing;
+        }
+        value_ /= static_cast<double>(period_);
+        return value_;
+    }
+    value_ += alpha_ * (value - value_);
+    return value_;
+}
+
+// --- BollingerBands ---
+
+BollingerBands::BollingerBands(size_t period, double width) : period_(std::max<size_t>(period, 1)), width_(width) {}
+
+/**
+ * Grows the window with Welford's update until it is full, then replaces the
+ * oldest value in one step.
+ *
+ * @param value The next close.
+ * @return The bands, or NaN during warm-up.
+ */
+BollingerBands::Value BollingerBands::add(double value) {
+    if (window_.size() < period_) {
+        window_.push_back(value);
+        double delta = value - mean_;
+        mean_ += delta / static_cast<double>(window_.size());
+        m2_ += delta * (value - mean_);
+    } else {
+        double oldest = window_.front();
+        window_.pop_front();
+        window_.push_back(value);
+        double delta = value - oldest;
+        double mean = mean_ + delta / static_cast<double>(period_);
+        m2_ = std::max(m2_ + delta * (value - mean + oldest - mean_), 0.0);
+        mean_ = mean;
+    }
+
+    if (window_.size() < period_) {
+        return {kMissing, kMissing, kMissing};
+    }
+    double spread = width_ * std::sqrt(m2_ / static_cast<double>(period_));
+    return {mean_, mean_ + spread, mean_ - spread};
+}
+
+// --- AverageTrueRange ---
+
+AverageTrueRange::AverageTrueRange(size_t period) : period_(std::max<size_t>(period, 1)) {}
+
+double AverageTrueRange::add(const Candlestick& candle) {
+    double true_range = candle.high - candle.low;
+    if (seen_ > 0) {
+        true_range = std::max({true_range, std::abs(candle.high - previous_close_),
+                               std::abs(candle.low - previous_close_)});
+    }
+    previous_close_ = candle.close;
+    ++seen_;
+
+    const double period = static_cast<double>(period_);
+    if (seen_ <= period_) {
+        value_ += true_range; // Sum of the seed window
+        if (seen_ < period_) {
+            return kMissing;
+        }
+        value_ /= period;
+        return value_;
+    }
+    value_ = (value_ * (period - 1.0) + true_range) / period;
+    return value_;
+}
+
+// --- RollingExtremes ---
+
+RollingExtremes::RollingExtremes(size_t period) : period_(std::max<size_t>(period, 1)) {}
+
+void RollingExtremes::add(const Candlestick& candle) {
+    const size_t index = seen_++;
+
+    while (!highs_.empty() && highs_.back().second <= candle.high) {
+        highs_.pop_back();
+    }
+    highs_.emplace_back(index, candle.high);
+    while (!lows_.empty() && lows_.back().second >= candle.low) {
+        lows_.pop_back();
+    }
+    lows_.emplace_back(index, candle.low);
+
+    // Drop candidates that slid out of the window
+    while (highs_.front().first + period_ <= index) {
+        highs_.pop_front();
+    }
+    while (lows_.front().first + period_ <= index) {
+        lows_.pop_front();
+    }
+}
+
+double RollingExtremes::high() const { return ready() ? highs_.front().second : kMissing; }
+
+double RollingExtremes::low() const { return ready() ? lows_.front().second : kMissing; }
+
+// --- Indicator specs ---
+
+/**
+ * Splits the text into a lower-case name and a trailing period.
+ *
+ * @param text The indicator, e.g. "sma20" or "BB20".
+ * @return The parsed spec.
+ */
+IndicatorSpec parseIndicator(const std::string& text) {
+    size_t digits = text.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(text[digits - 1]))) {
+        --digits;
+    }
+    std::string name = text.substr(0, digits);
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+
+    IndicatorSpec spec;
+    if (name == "sma") {
+        spec.kind = IndicatorKind::Sma;
+    } else if (name == "ema") {
+        spec.kind = IndicatorKind::Ema;
+    } else if (name == "bb") {
+        spec.kind = IndicatorKind::Bollinger;
+    } else if (name == "atr") {
+        spec.kind = IndicatorKind::Atr;
+    } else if (name == "donchian") {
+        spec.kind = IndicatorKind::Donchian;
+    } else {
+        throw std::runtime_error("Unknown indicator: " + text);
+    }
+
+    if (digits == text.size() || text.size() - digits > 6) {
+        throw std::runtime_error("Invalid indicator period: " + text);
+    }
+    spec.period = static_cast<size_t>(std::stoul(text.substr(digits)));
+    if (spec.period == 0) {
+        throw std::runtime_error("Invalid indicator period: " + text);
+    }
+    return spec;
+}
+
+std::string indicatorName(const IndicatorSpec& spec) {
+    std::string period = std::to_string(spec.period);
+    switch (spec.kind) {
+        case IndicatorKind::Sma: return "sma" + period;
+        case IndicatorKind::Ema: return "ema" + period;
+        case IndicatorKind::Bollinger: return "bb" + period;
+        case IndicatorKind::Atr: return "atr" + period;
+        case IndicatorKind::Donchian: return "donchian" + period;
+    }
+    return "";
+}
+
+// --- CandleIndicators ---
+
+CandleIndicators::CandleIndicators(const std::vector<IndicatorSpec>& specs) {
+    for (const auto& spec : specs) {
+        std::string name = indicatorName(spec);
+        switch (spec.kind) {
+            case IndicatorKind::Sma:
+                sma_.emplace_back(SimpleMovingAverage(spec.period), addSeries(name, '-'));
+                break;
+            case IndicatorKind::Ema:
+                ema_.emplace_back(ExponentialMovingAverage(spec.period), addSeries(name, '~'));
+                break;
+            case IndicatorKind::Bollinger: {
+                size_t first = addSeries(name + "_middle", ':');
+                addSeries(name + "_upper", '=');
+                addSeries(name + "_lower", '=');
+                bollinger_.emplace_back(BollingerBands(spec.period), first);
+                break;
+            }
+            case IndicatorKind::Atr:
+                atr_.emplace_back(AverageTrueRange(spec.period), addSeries(name, 0));
+                break;
+            case IndicatorKind::Donchian: {
+                size_t first = addSeries(name + "_high", '+');
+                addSeries(name + "_low", '+');
+                donchian_.emplace_back(RollingExtremes(spec.period), first);
+                break;
+            }
+        }
+    }
+}
+
+CandleIndicators::CandleIndicators(const std::vector<IndicatorSpec>& specs,
+                                   const std::vector<Candlestick>& candlesticks)
+    : CandleIndicators(specs) {
+    for (auto& values : values_) {
+        values.reserve(candlesticks.size());
+    }
+    for (const auto& candle : candlesticks) {
+        append(candle);
+    }
+}
+
+size_t CandleIndicators::addSeries(const std::string& name, char glyph) {
+    names_.push_back(name);
+    values_.emplace_back();
+    glyphs_.push_back(glyph);
+    return names_.size() - 1;
+}
+
+/**
+ * Feeds one candle to every indicator and appends one value to every series.
+ *
+ * @param candle The next candle, later than every candle so far.
+ */
+void CandleIndicators::append(const Candlestick& candle) {
+    for (auto& [sma, series] : sma_) {
+        values_[series].push_back(sma.add(candle.close));
+    }
+    for (auto& [ema, series] : ema_) {
+        values_[series].push_back(ema.add(candle.close));
+    }
+    for (auto& [bands, series] : bollinger_) {
+        BollingerBands::Value value = bands.add(candle.close);
+        values_[series].push_back(value.middle);
+        values_[series + 1].push_back(value.upper);
+        values_[series + 2].push_back(value.lower);
+    }
+    for (auto& [atr, series] : atr_) {
+        values_[series].push_back(atr.add(candle));
+    }
+    for (auto& [extremes, series] : donchian_) {
+        extremes.add(candle);
+        values_[series].push_back(extremes.high());
+        values_[series + 1].push_back(extremes.low());
+    }
+    ++size_;
+}
+
+std::vector<PlotOverlay> CandleIndicators::overlays() const {
+    std::vector<PlotOverlay> result;
+    for (size_t i = 0; i < values_.size(); ++i) {
+        if (glyphs_[i] != 0) {
+            result.push_back({values_[i], glyphs_[i]});
+        }
+    }
+    return result;
+}
@@ -0,0 +1,214 @@
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include "Candlestick.h"
+#include "CandlestickRenderer.h"
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+// --- Streaming indicators ---
+//
+// Each indicator keeps only its sliding-window state and is updated with one
+// candle (or close) at a time in O(1), amortised O(1) for the rolling extremes,
+// so a whole series costs O(n) whatever the period. Until the window is full
+// the result is NaN.
+
+/**
+ * @brief Simple moving average of the last `period` values.
+ */
+class SimpleMovingAverage {
+public:
+    explicit SimpleMovingAverage(size_t period);
+
+    /**
+     * @brief Adds a value and returns the average, or NaN during warm-up.
+     */
+    double add(double value);
+
+private:
+    size_t period_;
+    std::deque<double> window_;
+    double sum_ = 0.0;
+};
+
+/**
+ * @brief Exponential moving average with alpha = 2 / (period + 1).
+ *
+ * Seeded with the simple average of the first `period` values, as charting
+ * packages do, so the first value appears at the same candle as the SMA's.
+ */
+class ExponentialMovingAverage {
+public:
+    explicit ExponentialMovingAverage(size_t period);
+
+    double add(double value);
+
+private:
+    size_t period_;
+    double alpha_;
+    size_t seen_ = 0;
+    double value_ = 0.0;
+};
+
+/**
+ * @brief Bollinger bands: the SMA plus and minus `width` standard deviations.
+ *
+ * The window's mean and sum of squared deviations are slid with Welford-style
+ * updates (one value in, one out), which stays accurate where the naive
+ * sum-of-squares formula would cancel.
+ */
+class BollingerBands {
+public:
+    struct Value {
+        double middle;
+        double upper;
+        double lower;
+    };
+
+    explicit BollingerBands(size_t period, double width = 2.0);
+
+    Value add(double value);
+
+private:
+    size_t period_;
+    double width_;
+    std::deque<double> window_;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+/**
+ * @brief Average true range with Wilder's smoothing.
+ *
+ * The true range of a candle is its high - low, widened to reach the previous
+ * close. The first ATR is the mean of the first `period` true ranges; later
+ * ones are (previous * (period - 1) + true range) / period.
+ */
+class AverageTrueRange {
+public:
+    explicit AverageTrueRange(size_t period);
+
+    double add(const Candlestick& candle);
+
+private:
+    size_t period_;
+    size_t seen_ = 0;
+    double previous_close_ = 0.0;
+    double value_ = 0.0;
+};
+
+/**
+ * @brief Highest high and lowest low of the last `period` candles (Donchian channel).
+ *
+ * Two monotonic deques hold the candidates: the front of each is the current
+ * extreme, and a new candle evicts every older candidate it dominates, so
+ * every candle is pushed and popped at most once.
+ */
+class RollingExtremes {
+public:
+    explicit RollingExtremes(size_t period);
+
+    void add(const Candlestick& candle);
+
+    bool ready() const { return seen_ >= period_; }
+
+    /**
+     * @brief Highest high in the window, or NaN during warm-up.
+     */
+    double high() const;
+
+    /**
+     * @brief Lowest low in the window, or NaN during warm-up.
+     */
+    double low() const;
+
+private:
+    size_t period_;
+    size_t seen_ = 0;
+    std::deque<std::pair<size_t, double>> highs_; // (candle, high), highs descending.
+    std::deque<std::pair<size_t, double>> lows_;  // (candle, low), lows ascending.
+};
+
+// --- Indicator sets ---
+
+enum class IndicatorKind { Sma, Ema, Bollinger, Atr, Donchian };
+
+/**
+ * @brief An indicator and its period, e.g. "sma20".
+ */
+struct IndicatorSpec {
+    IndicatorKind kind = IndicatorKind::Sma;
+    size_t period = 20;
+};
+
+/**
+ * @brief Parses "sma<N>", "ema<N>", "bb<N>", "atr<N>" or "donchian<N>".
+ *
+ * @throws std::runtime_error if the text is not an indicator or N is not a positive integer.
+ */
+IndicatorSpec parseIndicator(const std::string& text);
+
+/**
+ * @brief Canonical name of an indicator, as parseIndicator accepts it.
+ */
+std::string indicatorName(const IndicatorSpec& spec);
+
+/**
+ * @brief Several indicators over one candle series, kept in step as candles are appended.
+ *
+ * Each indicator contributes one or more named series aligned with the
+ * candles: "sma20", "ema12", "atr14", "bb20_middle"/"bb20_upper"/"bb20_lower"
+ * and "donchian20_high"/"donchian20_low". Moving averages are computed on the
+ * close. append() updates every series in O(1) amortised, so a live chart
+ * never recomputes its history.
+ */
+class CandleIndicators {
+public:
+    explicit CandleIndicators(const std::vector<IndicatorSpec>& specs);
+
+    /**
+     * @brief Computes every indicator over a series, as if each candle were appended in turn.
+     */
+    CandleIndicators(const std::vector<IndicatorSpec>& specs, const std::vector<Candlestick>& candlesticks);
+
+    void append(const Candlestick& candle);
+
+    size_t size() const { return size_; }
+    size_t seriesCount() const { return names_.size(); }
+    const std::string& seriesName(size_t series) const { return names_[series]; }
+    const std::vector<double>& series(size_t series) const { return values_[series]; }
+
+    /**
+     * @brief The glyph a series is drawn with, or 0 if it is not drawn.
+     */
+    char seriesGlyph(size_t series) const { return glyphs_[series]; }
+
+    /**
+     * @brief The series to draw over a chart of the candles.
+     *
+     * ATR is a range, not a temperature, so it is left out. Glyphs: '-' SMA,
+     * '~' EMA, ':' Bollinger middle, '=' Bollinger bands, '+' Donchian channel.
+     */
+    std::vector<PlotOverlay> overlays() const;
+
+private:
+    size_t addSeries(const std::string& name, char glyph);
+
+    std::vector<std::string> names_;
+    std::vector<std::vector<double>> values_;
+    std::vector<char> glyphs_; // 0 for series that are not drawn.
+    size_t size_ = 0;
+
+    // Indicator state and the index of its first series
+    std::vector<std::pair<SimpleMovingAverage, size_t>> sma_;
+    std::vector<std::pair<ExponentialMovingAverage, size_t>> ema_;
+    std::vector<std::pair<BollingerBands, size_t>> bollinger_;
+    std::vector<std::pair<AverageTrueRange, size_t>> atr_;
+    std::vector<std::pair<RollingExtremes, size_t>> donchian_;
+};
+
+#endif // INDICATORS_H
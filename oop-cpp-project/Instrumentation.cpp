@@ -0,0 +1,209 @@
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct StageTotals {
+    uint64_t calls = 0;
+    int64_t total_ns = 0;
+    int64_t max_ns = 0;
+};
+
+struct TraceEvent {
+    const char* stage;
+    uint32_t thread;
+    int64_t start_ns;
+    int64_t end_ns;
+};
+
+// Bounds trace memory on long-running servers; later events are counted, not kept.
+const size_t kMaxTraceEvents = 1000000;
+
+const char* const kCounterNames[] = {
+    "rows_read", "cells_parsed", "invalid_cells", "buckets_created", "bytes_allocated",
+};
+
+std::mutex stage_mutex;
+std::map<std::string, StageTotals> stage_totals;
+std::vector<TraceEvent> trace_events;
+uint64_t dropped_trace_events = 0;
+bool tracing = false;
+int64_t run_start_ns = 0;
+
+std::atomic<uint32_t> next_thread_id{0};
+std::string exit_report_file;
+std::string exit_trace_file;
+
+/**
+ * Small, stable id for the calling thread (trace viewers group rows by it).
+ */
+uint32_t currentThreadId() {
+    thread_local uint32_t id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+/**
+ * Writes s as a JSON string literal.
+ */
+void writeJsonString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * Opens filename for writing, or reports why it could not be opened.
+ */
+bool openOutput(const std::string& filename, std::ofstream& file) {
+    file.open(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open stats file " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void writeReportsOnExit() {
+    if (!exit_report_file.empty()) {
+        Instrumentation::writeReport(exit_report_file);
+    }
+    if (!exit_trace_file.empty()) {
+        Instrumentation::writeTrace(exit_trace_file);
+    }
+}
+
+} // namespace
+
+// --- Collection ---
+
+void Instrumentation::enable(bool trace_events) {
+    std::lock_guard<std::mutex> lock(stage_mutex);
+    tracing = tracing || trace_events;
+    if (!enabled()) {
+        run_start_ns = nowNs();
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+}
+
+int64_t Instrumentation::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Instrumentation::recordStage(const char* stage, int64_t start_ns, int64_t end_ns) {
+    uint32_t thread = currentThreadId();
+    int64_t duration = end_ns - start_ns;
+
+    std::lock_guard<std::mutex> lock(stage_mutex);
+    StageTotals& totals = stage_totals[stage];
+    ++totals.calls;
+    totals.total_ns += duration;
+    totals.max_ns = std::max(totals.max_ns, duration);
+
+    if (tracing) {
+        if (trace_events.size() < kMaxTraceEvents) {
+            trace_events.push_back({stage, thread, start_ns, end_ns});
+        } else {
+            ++dropped_trace_events;
+        }
+    }
+}
+
+// --- Reports ---
+
+/**
+ * Report layout:
+ *
+ *     {"wall_time_ms": ..., "counters": {"rows_read": ..., ...},
+ *      "stages": {"load.parse": {"calls": 1, "total_ms": ..., "max_ms": ...}, ...}}
+ */
+bool Instrumentation::writeReport(const std::string& filename) {
+    std::ofstream file;
+    if (filename != "-" && !openOutput(filename, file)) {
+        return false;
+    }
+    std::ostream& out = filename == "-" ? std::cerr : file;
+
+    std::lock_guard<std::mutex> lock(stage_mutex);
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"wall_time_ms\": " << (nowNs() - run_start_ns) / 1e6 << ",\n  \"counters\": {";
+    for (size_t i = 0; i < kCounterCount; ++i) {
+        out << (i == 0 ? "\n" : ",\n") << "    \"" << kCounterNames[i] << "\": "
+            << counters_[i].load(std::memory_order_relaxed);
+    }
+    out << "\n  },\n  \"stages\": {";
+    bool first = true;
+    for (const auto& [stage, totals] : stage_totals) {
+        out << (first ? "\n" : ",\n") << "    ";
+        writeJsonString(out, stage);
+        out << ": {\"calls\": " << totals.calls << ", \"total_ms\": " << totals.total_ns / 1e6
+            << ", \"max_ms\": " << totals.max_ns / 1e6 << "}";
+        first = false;
+    }
+    out << "\n  }\n}\n";
+    out.flush();
+
+    if (!out) {
+        std::cerr << "Error: Failed to write stats file " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Complete ("X") events with microsecond timestamps relative to enable().
+ */
+bool Instrumentation::writeTrace(const std::string& filename) {
+    std::ofstream out;
+    if (!openOutput(filename, out)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(stage_mutex);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": " << dropped_trace_events
+        << "},\n\"traceEvents\": [";
+    for (size_t i = 0; i < trace_events.size(); ++i) {
+        const TraceEvent& event = trace_events[i];
+        out << (i == 0 ? "\n" : ",\n") << "{\"name\": ";
+        writeJsonString(out, event.stage);
+        out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+            << ", \"ts\": " << (event.start_ns - run_start_ns) / 1e3
+            << ", \"dur\": " << (event.end_ns - event.start_ns) / 1e3 << "}";
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        std::cerr << "Error: Failed to write trace file " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Instrumentation::writeAtExit(const std::string& report_file, const std::string& trace_file) {
+    static bool registered = false;
+    exit_report_file = report_file;
+    exit_trace_file = trace_file;
+    enable(!trace_file.empty());
+    if (!registered) {
+        std::atexit(writeReportsOnExit);
+        registered = true;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Run-wide event counters.
+ */
+enum class Counter {
+    RowsRead,       ///< Data rows taken from the CSV (or the cache).
+    CellsParsed,    ///< Numeric cells converted from text.
+    InvalidCells,   ///< Cells that were empty or not a number and were skipped.
+    BucketsCreated, ///< Time buckets created while building candles.
+    BytesAllocated, ///< Bytes reserved for column, bucket and candle buffers.
+};
+
+/**
+ * @brief Per-stage timers and counters for a run, reported as JSON.
+ *
+ * Everything is off until enable() is called. While off, a counter update or
+ * a ScopedTimer costs one relaxed atomic load and a branch, so the hooks can
+ * stay in production code. Hot loops should still count locally and add once
+ * per batch.
+ *
+ * Stage timings are aggregated by name (calls, total and longest duration).
+ * With tracing on, every timed scope is also kept as a Chrome trace event,
+ * viewable in chrome://tracing or Perfetto.
+ */
+class Instrumentation {
+public:
+    /**
+     * @brief Starts collecting. Call before any other thread is started.
+     *
+     * @param trace_events Also record each timed scope for writeTrace.
+     */
+    static void enable(bool trace_events);
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static void add(Counter counter, uint64_t amount) {
+        if (enabled()) {
+            counters_[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    static uint64_t count(Counter counter) {
+        return counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records one finished scope; used by ScopedTimer.
+     *
+     * @param stage The stage name; must outlive the run (a string literal).
+     * @param start_ns Start, in steady-clock nanoseconds.
+     * @param end_ns End, in steady-clock nanoseconds.
+     */
+    static void recordStage(const char* stage, int64_t start_ns, int64_t end_ns);
+
+    static int64_t nowNs();
+
+    /**
+     * @brief Writes counters and stage timings as a JSON object.
+     *
+     * @param filename The report path; "-" writes to stderr.
+     * @return True on success; failures are reported on stderr.
+     */
+    static bool writeReport(const std::string& filename);
+
+    /**
+     * @brief Writes the recorded scopes in Chrome trace-event format.
+     *
+     * @param filename The trace path.
+     * @return True on success; failures are reported on stderr.
+     */
+    static bool writeTrace(const std::string& filename);
+
+    /**
+     * @brief Writes the report (and trace, if a path is given) when the process exits.
+     *
+     * Enables collection if it is not already on.
+     *
+     * @param report_file The JSON report path; empty to skip.
+     * @param trace_file The trace path; empty to skip (and not record events).
+     */
+    static void writeAtExit(const std::string& report_file, const std::string& trace_file);
+
+private:
+    static constexpr size_t kCounterCount = static_cast<size_t>(Counter::BytesAllocated) + 1;
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::atomic<uint64_t> counters_[kCounterCount] = {};
+};
+
+/**
+ * @brief Times the enclosing scope as one call of a named stage.
+ *
+ *     ScopedTimer timer("candles.group");
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* stage)
+        : stage_(stage), start_ns_(Instrumentation::enabled() ? Instrumentation::nowNs() : -1) {}
+
+    ~ScopedTimer() {
+        if (start_ns_ >= 0) {
+            Instrumentation::recordStage(stage_, start_ns_, Instrumentation::nowNs());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* stage_;
+    int64_t start_ns_;
+};
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,427 @@
+#include "OnlineForecaster.h"
+#include "DateTime.h"
+#include "WeatherCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+
+namespace {
+
+const char kStateMagic[] = "WXFCAST";
+const int kStateVersion = 3; // 3: reading count and stale flag
+
+} // namespace
+
+// --- OnlineForecaster ---
+
+OnlineForecaster::OnlineForecaster(int degree, double year_center, double year_scale)
+    : degree_(std::max(degree, 0)),
+      year_center_(year_center),
+      year_scale_(year_scale > 0 ? year_scale : 1.0),
+      normal_((degree_ + 1) * (degree_ + 1), 0.0),
+      moment_(degree_ + 1, 0.0) {}
+
+/**
+ * Powers 0..degree of the scaled year.
+ */
+std::vector<double> OnlineForecaster::basis(int year) const {
+    std::vector<double> phi(degree_ + 1);
+    double t = (year - year_center_) / year_scale_;
+    double power = 1.0;
+    for (auto& value : phi) {
+        value = power;
+        power *= t;
+    }
+    return phi;
+}
+
+/**
+ * Rank-one update of the sufficient statistics.
+ */
+void OnlineForecaster::accumulate(const std::vector<double>& phi, double value, std::vector<double>& normal,
+                                  std::vector<double>& moment, double& sum_squares) const {
+    const size_t m = phi.size();
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            normal[i * m + j] += phi[i] * phi[j];
+        }
+        moment[i] += phi[i] * value;
+    }
+    sum_squares += value * value;
+}
+
+/**
+ * Folds a reading into the open year, closing it first if the reading starts a new year.
+ *
+ * @param timestamp The reading's time (epoch seconds).
+ * @param temperature The reading; NaN is ignored.
+ * @return False if the reading belongs to a closed year; the forecaster is then stale.
+ */
+bool OnlineForecaster::addReading(int64_t timestamp, double temperature) {
+    last_timestamp_ = std::max(last_timestamp_, timestamp);
+    ++readings_;
+    if (std::isnan(temperature)) {
+        return true;
+    }
+    int year = civilFromEpoch(timestamp).year;
+    if (!open_.empty() && year < open_year_) {
+        stale_ = true;
+        return false;
+    }
+    if (!open_.empty() && year != open_year_) {
+        addYear(open_year_, (open_.high + open_.low) / 2);
+        open_ = OhlcAccumulator();
+    }
+    if (samples_ == 0) {
+        first_year_ = year;
+    }
+    open_year_ = last_year_ = year;
+    open_.add(temperature);
+    return true;
+}
+
+/**
+ * Adds a finished yearly value.
+ *
+ * @param year The year.
+ * @param value The yearly value.
+ */
+void OnlineForecaster::addYear(int year, double value) {
+    const bool first = samples_ == 0 && open_.empty();
+    first_year_ = first ? year : std::min(first_year_, year);
+    last_year_ = first ? year : std::max(last_year_, year);
+    accumulate(basis(year), value, normal_, moment_, sum_squares_);
+    ++samples_;
+}
+
+/**
+ * Compares the years folded in (closed and open) with a window's years.
+ *
+ * @param years Ascending years.
+ * @return True if the fit uses exactly those years and missed no reading.
+ */
+bool OnlineForecaster::covers(const std::vector<int>& years) const {
+    if (stale_) {
+        return false;
+    }
+    size_t folded = samples_ + (open_.empty() ? 0 : 1);
+    return !years.empty() && folded == years.size() && first_year_ == years.front() && last_year_ == years.back();
+}
+
+/**
+ * Solves the normal equations with diagonally pivoted Cholesky. Directions
+ * whose pivot falls below a relative tolerance are dropped, which gives a
+ * basic solution for rank-deficient data (e.g. fewer years than coefficients).
+ *
+ * @param include_open_year Whether the partially observed current year counts.
+ * @return The fit, in the forecaster's scaled coordinates.
+ */
+PolynomialFit OnlineForecaster::fit(bool include_open_year) const {
+    const size_t m = static_cast<size_t>(degree_) + 1;
+    std::vector<double> a = normal_;
+    std::vector<double> b = moment_;
+    double sum_squares = sum_squares_;
+    size_t samples = samples_;
+    if (include_open_year && !open_.empty()) {
+        accumulate(basis(open_year_), (open_.high + open_.low) / 2, a, b, sum_squares);
+        ++samples;
+    }
+
+    PolynomialFit result;
+    result.degree = degree_;
+    result.x_center = year_center_;
+    result.x_scale = year_scale_;
+    result.samples = samples;
+    result.coefficients.assign(m, 0.0);
+
+    std::vector<size_t> permutation(m);
+    for (size_t i = 0; i < m; ++i) {
+        permutation[i] = i;
+    }
+
+    // In-place factorisation P^T A P = L L^T, with L in the lower triangle of a.
+    double first_pivot = 0.0;
+    size_t rank = 0;
+    for (size_t k = 0; k < m; ++k) {
+        size_t best = k;
+        for (size_t j = k + 1; j < m; ++j) {
+            if (a[j * m + j] > a[best * m + best]) {
+                best = j;
+            }
+        }
+        if (best != k) {
+            for (size_t i = 0; i < m; ++i) {
+                std::swap(a[k * m + i], a[best * m + i]);
+            }
+            for (size_t i = 0; i < m; ++i) {
+                std::swap(a[i * m + k], a[i * m + best]);
+            }
+            std::swap(b[k], b[best]);
+            std::swap(permutation[k], permutation[best]);
+        }
+
+        double pivot = a[k * m + k];
+        if (k == 0) {
+            first_pivot = pivot;
+        }
+        if (pivot <= 1e-12 * first_pivot || pivot <= 0.0) {
+            break; // The remaining directions are numerically dependent
+        }
+
+        double diagonal = std::sqrt(pivot);
+        a[k * m + k] = diagonal;
+        for (size_t i = k + 1; i < m; ++i) {
+            a[i * m + k] /= diagonal;
+        }
+        for (size_t i = k + 1; i < m; ++i) {
+            for (size_t j = k + 1; j <= i; ++j) {
+                a[i * m + j] -= a[i * m + k] * a[j * m + k];
+                a[j * m + i] = a[i * m + j];
+            }
+        }
+        rank = k + 1;
+    }
+    result.rank = rank;
+
+    // Forward then back substitution over the leading `rank` unknowns.
+    std::vector<double> z(m, 0.0);
+    for (size_t i = 0; i < rank; ++i) {
+        double sum = b[i];
+        for (size_t j = 0; j < i; ++j) {
+            sum -= a[i * m + j] * z[j];
+        }
+        z[i] = sum / a[i * m + i];
+    }
+    for (size_t i = rank; i-- > 0;) {
+        double sum = z[i];
+        for (size_t j = i + 1; j < rank; ++j) {
+            sum -= a[j * m + i] * z[j];
+        }
+        z[i] = sum / a[i * m + i];
+    }
+    for (size_t i = 0; i < m; ++i) {
+        result.coefficients[permutation[i]] = z[i];
+    }
+
+    // SSR = y^T y - c^T X^T y at the least-squares solution.
+    if (samples > 0) {
+        double explained = 0.0;
+        for (size_t i = 0; i < m; ++i) {
+            explained += z[i] * b[i];
+        }
+        double residual = std::max(0.0, sum_squares - explained);
+        result.rms_error = std::sqrt(residual / static_cast<double>(samples));
+    }
+    return result;
+}
+
+/**
+ * Predicts yearly values.
+ *
+ * @param years The years to predict.
+ * @param include_open_year Whether the partially observed current year counts.
+ * @return One prediction per year.
+ */
+std::vector<double> OnlineForecaster::predict(const std::vector<int>& years, bool include_open_year) const {
+    PolynomialFit model = fit(include_open_year);
+    std::vector<double> predictions;
+    predictions.reserve(years.size());
+    for (int year : years) {
+        predictions.push_back(model.evaluate(year));
+    }
+    return predictions;
+}
+
+/**
+ * Writes the state with 17 significant digits so doubles round-trip exactly.
+ *
+ * @param out The stream to write to.
+ */
+void OnlineForecaster::save(std::ostream& out) const {
+    auto precision = out.precision(std::numeric_limits<double>::max_digits10);
+    out << degree_ << ' ' << year_center_ << ' ' << year_scale_ << ' ' << samples_ << ' ' << sum_squares_;
+    for (double value : normal_) {
+        out << ' ' << value;
+    }
+    for (double value : moment_) {
+        out << ' ' << value;
+    }
+    out << ' ' << open_year_ << ' ' << open_.count << ' ' << open_.open << ' ' << open_.high << ' '
+        << open_.low << ' ' << open_.close << ' ' << open_.sum << ' ' << first_year_ << ' ' << last_year_ << ' '
+        << last_timestamp_ << ' ' << readings_ << ' ' << stale_ << '\n';
+    out.precision(precision);
+}
+
+/**
+ * Reads a record written by save().
+ *
+ * @param in The stream to read from.
+ * @return False if the record is malformed; the state is then unchanged.
+ */
+bool OnlineForecaster::restore(std::istream& in) {
+    int degree = 0;
+    double center = 0.0;
+    double scale = 0.0;
+    if (!(in >> degree >> center >> scale) || degree < 0 || degree > 64 || !(scale > 0)) {
+        return false;
+    }
+
+    OnlineForecaster state(degree, center, scale);
+    in >> state.samples_ >> state.sum_squares_;
+    for (double& value : state.normal_) {
+        in >> value;
+    }
+    for (double& value : state.moment_) {
+        in >> value;
+    }
+    in >> state.open_year_ >> state.open_.count >> state.open_.open >> state.open_.high >> state.open_.low
+       >> state.open_.close >> state.open_.sum >> state.first_year_ >> state.last_year_ >> state.last_timestamp_
+       >> state.readings_ >> state.stale_;
+    if (!in) {
+        return false;
+    }
+
+    *this = std::move(state);
+    return true;
+}
+
+// --- Per-country helpers ---
+
+/**
+ * Feeds the rows after the forecaster's latest reading, then rebuilds the
+ * forecaster in timestamp order if it is stale or its reading count shows that
+ * the earlier rows changed.
+ *
+ * @param forecasters Forecasters keyed by country prefix.
+ * @param table The loaded weather data.
+ * @param country_prefix The country to update.
+ * @param degree The polynomial degree.
+ * @return The country's forecaster.
+ */
+OnlineForecaster& updateForecaster(std::map<std::string, OnlineForecaster>& forecasters,
+                                   const WeatherTable& table,
+                                   const std::string& country_prefix,
+                                   int degree) {
+    const std::vector<double>& column = table.temperatureColumn(country_prefix);
+    auto it = forecasters.find(country_prefix);
+    if (it == forecasters.end() || it->second.degree() != degree) {
+        it = forecasters.insert_or_assign(country_prefix, OnlineForecaster(degree)).first;
+    }
+
+    OnlineForecaster& forecaster = it->second;
+    const int64_t seen = forecaster.lastTimestamp();
+    const size_t folded = forecaster.readings();
+    size_t earlier = 0;
+    for (size_t row = 0; row < column.size(); ++row) {
+        if (table.timestamps[row] > seen) {
+            forecaster.addReading(table.timestamps[row], column[row]);
+        } else {
+            ++earlier;
+        }
+    }
+    if (!forecaster.stale() && earlier == folded) {
+        return forecaster;
+    }
+
+    std::vector<size_t> order(column.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&table](size_t a, size_t b) {
+        return table.timestamps[a] < table.timestamps[b];
+    });
+    OnlineForecaster rebuilt(degree);
+    for (size_t row : order) {
+        rebuilt.addReading(table.timestamps[row], column[row]);
+    }
+    forecaster = std::move(rebuilt);
+    return forecaster;
+}
+
+/**
+ * Streams every row of the table through one forecaster per country.
+ *
+ * @param table The loaded weather data.
+ * @param degree The polynomial degree.
+ * @param country_prefixes The countries to track; empty means every country.
+ * @return Forecasters keyed by country prefix.
+ */
+std::map<std::string, OnlineForecaster> buildOnlineForecasters(const WeatherTable& table,
+                                                               int degree,
+                                                               const std::vector<std::string>& country_prefixes) {
+    std::vector<std::string> prefixes = country_prefixes.empty() ? table.countryPrefixes() : country_prefixes;
+
+    std::map<std::string, OnlineForecaster> forecasters;
+    for (const auto& prefix : prefixes) {
+        updateForecaster(forecasters, table, prefix, degree);
+    }
+    return forecasters;
+}
+
+/**
+ * Writes a header line and one "<prefix> <state>" line per forecaster to a
+ * temporary file of its own, then moves it over the target.
+ *
+ * @param forecasters The states to save.
+ * @param filename Where to write them.
+ * @return False on any write error.
+ */
+bool saveForecasters(const std::map<std::string, OnlineForecaster>& forecasters, const std::string& filename) {
+    const std::string temp_filename = temporaryFileName(filename);
+    std::ofstream file(temp_filename, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << kStateMagic << ' ' << kStateVersion << ' ' << forecasters.size() << '\n';
+    for (const auto& [prefix, forecaster] : forecasters) {
+        file << prefix << ' ';
+        forecaster.save(file);
+    }
+
+    file.close();
+    if (!file) {
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+
+    if (!replaceFile(temp_filename, filename)) {
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Reads a file written by saveForecasters.
+ *
+ * @param filename The file to read.
+ * @param forecasters Receives the states on success.
+ * @return False if the file is missing or malformed.
+ */
+bool loadForecasters(const std::string& filename, std::map<std::string, OnlineForecaster>& forecasters) {
+    std::ifstream file(filename);
+    std::string magic;
+    int version = 0;
+    size_t count = 0;
+    if (!(file >> magic >> version >> count) || magic != kStateMagic || version != kStateVersion) {
+        return false;
+    }
+
+    std::map<std::string, OnlineForecaster> loaded;
+    for (size_t i = 0; i < count; ++i) {
+        std::string prefix;
+        OnlineForecaster forecaster;
+        if (!(file >> prefix) || !forecaster.restore(file)) {
+            return false;
+        }
+        loaded.emplace(prefix, std::move(forecaster));
+    }
+
+    forecasters = std::move(loaded);
+    return true;
+}
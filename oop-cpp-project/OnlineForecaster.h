@@ -0,0 +1,174 @@
+#ifndef ONLINE_FORECASTER_H
+#define ONLINE_FORECASTER_H
+
+#include "CandlestickAggregator.h"
+#include "Regression.h"
+#include "WeatherTable.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Incremental yearly temperature forecaster for one country.
+ *
+ * Hourly readings are folded into the current year's OHLC state. When a
+ * reading for a later year arrives, the finished year's (high + low) / 2
+ * value is added to the least-squares sufficient statistics. These are the
+ * normal matrix sum(phi phi^T), the vector sum(phi y) and sum(y^2), with phi the
+ * powers of the scaled year. An update costs O(degree^2) and never revisits
+ * history.
+ *
+ * Years are scaled by a fixed centre and scale chosen at construction, so the
+ * statistics stay well conditioned and never need rebasing. A fit solves the
+ * normal equations with pivoted Cholesky in O(degree^3). The still-open year is
+ * included the same way displayTemperaturePrediction includes a partial final
+ * year.
+ *
+ * The forecaster remembers the latest reading it has seen, so a saved state
+ * can be brought up to date with only the rows appended since (see
+ * updateForecaster).
+ *
+ * A reading for a year that is already closed cannot be folded in. It marks
+ * the forecaster stale instead: its statistics miss data, covers() refuses
+ * every window, and updateForecaster rebuilds it in timestamp order.
+ */
+class OnlineForecaster {
+public:
+    /**
+     * @param degree The polynomial degree.
+     * @param year_center Years are mapped to (year - year_center) / year_scale.
+     * @param year_scale See year_center; should be about half the expected year span.
+     */
+    explicit OnlineForecaster(int degree = 2, double year_center = 2000.0, double year_scale = 50.0);
+
+    /**
+     * @brief Adds one hourly reading. NaN readings are ignored.
+     *
+     * @return False if the reading belongs to a year that is already closed;
+     *         the forecaster is then stale.
+     */
+    bool addReading(int64_t timestamp, double temperature);
+
+    /**
+     * @brief Adds a finished yearly value directly, in O(degree^2).
+     */
+    void addYear(int year, double value);
+
+    /**
+     * @brief Solves for the current polynomial.
+     *
+     * @param include_open_year Whether the partially observed current year counts.
+     */
+    PolynomialFit fit(bool include_open_year = true) const;
+
+    /**
+     * @brief Predicts the yearly value for each year using fit().
+     */
+    std::vector<double> predict(const std::vector<int>& years, bool include_open_year = true) const;
+
+    /**
+     * @brief Whether the fit covers exactly these years, e.g. a report's whole window.
+     *
+     * @param years Ascending years, one per yearly value.
+     * @return False for a stale forecaster, whatever the years.
+     */
+    bool covers(const std::vector<int>& years) const;
+
+    int degree() const { return degree_; }
+    size_t closedYears() const { return samples_; }
+    int openYear() const { return open_year_; }
+    const OhlcAccumulator& openYearState() const { return open_; }
+    int64_t lastTimestamp() const { return last_timestamp_; }
+    size_t readings() const { return readings_; }
+    bool stale() const { return stale_; }
+
+    /**
+     * @brief Writes the state as one whitespace-separated record, with doubles round-tripped exactly.
+     */
+    void save(std::ostream& out) const;
+
+    /**
+     * @brief Reads a record written by save().
+     *
+     * @return False if the record is malformed.
+     */
+    bool restore(std::istream& in);
+
+private:
+    void accumulate(const std::vector<double>& phi, double value, std::vector<double>& normal,
+                    std::vector<double>& moment, double& sum_squares) const;
+    std::vector<double> basis(int year) const;
+
+    int degree_;
+    double year_center_;
+    double year_scale_;
+    std::vector<double> normal_;  // (degree+1)^2, row-major sum(phi phi^T).
+    std::vector<double> moment_;  // degree+1, sum(phi y).
+    double sum_squares_ = 0.0;    // sum(y^2), for the residual.
+    size_t samples_ = 0;
+    int open_year_ = 0;
+    OhlcAccumulator open_;
+    int first_year_ = 0;  // Earliest and latest year seen, closed or open.
+    int last_year_ = 0;
+    int64_t last_timestamp_ = std::numeric_limits<int64_t>::min(); // Latest reading passed to addReading.
+    size_t readings_ = 0;  // Readings passed to addReading, NaN included.
+    bool stale_ = false;   // A reading was rejected, so the statistics miss data.
+};
+
+/**
+ * @brief Brings a country's forecaster up to date with a table.
+ *
+ * Only rows after the forecaster's latest reading are folded in, so a state
+ * restored by loadForecasters costs one pass over the newly appended rows. A
+ * missing forecaster, or one of another degree, is rebuilt from every row.
+ * So is a stale one, or one whose reading count no longer matches the rows up
+ * to its latest reading (rows were inserted or removed); the rebuild feeds the
+ * rows in timestamp order, so out-of-order input is fitted in full.
+ *
+ * @param forecasters Forecasters keyed by country prefix; the country's entry is created or updated.
+ * @param table The loaded weather data.
+ * @param country_prefix The country to update.
+ * @param degree The polynomial degree.
+ * @return The country's forecaster.
+ * @throws std::runtime_error if the country is unknown.
+ */
+OnlineForecaster& updateForecaster(
+    std::map<std::string, OnlineForecaster>& forecasters,
+    const WeatherTable& table,
+    const std::string& country_prefix,
+    int degree
+);
+
+/**
+ * @brief Seeds one forecaster per country from a loaded table.
+ *
+ * @param table The loaded weather data.
+ * @param degree The polynomial degree.
+ * @param country_prefixes The countries to track; empty means every country.
+ * @return Forecasters keyed by country prefix.
+ */
+std::map<std::string, OnlineForecaster> buildOnlineForecasters(
+    const WeatherTable& table,
+    int degree,
+    const std::vector<std::string>& country_prefixes = {}
+);
+
+/**
+ * @brief Saves forecaster states to a file, replacing it atomically.
+ *
+ * @return False on any write error.
+ */
+bool saveForecasters(const std::map<std::string, OnlineForecaster>& forecasters, const std::string& filename);
+
+/**
+ * @brief Restores forecaster states written by saveForecasters.
+ *
+ * @return False if the file is missing or malformed; forecasters is left unchanged.
+ */
+bool loadForecasters(const std::string& filename, std::map<std::string, OnlineForecaster>& forecasters);
+
+#endif // ONLINE_FORECASTER_H
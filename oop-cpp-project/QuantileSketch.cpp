@@ -0,0 +1,151 @@
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+} // namespace
+
+QuantileSketch::QuantileSketch(double compression) : compression_(std::max(compression, 10.0)) {}
+
+void QuantileSketch::add(double value) {
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    ++count_;
+
+    buffer_.push_back({value, 1.0});
+    if (buffer_.size() >= static_cast<size_t>(compression_ * 5)) {
+        compress();
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.empty()) {
+        return;
+    }
+    if (empty()) {
+        min_ = other.min_;
+        max_ = other.max_;
+    } else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    count_ += other.count_;
+
+    buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+    buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+    if (buffer_.size() >= static_cast<size_t>(compression_ * 5)) {
+        compress();
+    }
+}
+
+void QuantileSketch::compress() {
+    if (buffer_.empty()) {
+        return;
+    }
+    centroids_.insert(centroids_.end(), buffer_.begin(), buffer_.end());
+    buffer_.clear();
+    compressInto(centroids_);
+}
+
+/**
+ * Sorts the centroids and merges neighbours greedily while the merged
+ * centroid spans at most one unit of the scale function
+ * k(q) = compression / (2 pi) * asin(2q - 1). k is steep near q = 0 and 1, so
+ * tail centroids stay small, and its total range of compression / 2 bounds
+ * the number of centroids.
+ *
+ * @param centroids The centroids to compress, in any order.
+ */
+void QuantileSketch::compressInto(std::vector<Centroid>& centroids) const {
+    std::sort(centroids.begin(), centroids.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    double total = 0.0;
+    for (const auto& centroid : centroids) {
+        total += centroid.weight;
+    }
+    const double normalizer = compression_ / (2.0 * kPi);
+    auto scale = [normalizer](double q) {
+        return normalizer * std::asin(std::min(std::max(2.0 * q - 1.0, -1.0), 1.0));
+    };
+
+    size_t kept = 0;
+    double weight_before = 0.0; // Weight of the centroids before centroids[kept]
+    double k_left = scale(0.0);
+    for (size_t i = 1; i < centroids.size(); ++i) {
+        Centroid& current = centroids[kept];
+        const Centroid& next = centroids[i];
+        double merged_weight = current.weight + next.weight;
+
+        if (scale((weight_before + merged_weight) / total) - k_left <= 1.0) {
+            current.mean += (next.mean - current.mean) * next.weight / merged_weight;
+            current.weight = merged_weight;
+        } else {
+            weight_before += current.weight;
+            k_left = scale(weight_before / total);
+            centroids[++kept] = next;
+        }
+    }
+    centroids.resize(centroids.empty() ? 0 : kept + 1);
+}
+
+/**
+ * Each centroid's weight is centred on its mean; the rank q * n is located
+ * between two centroid centres and interpolated linearly.
+ *
+ * @param q The probability.
+ * @return The estimated quantile.
+ */
+double QuantileSketch::quantile(double q) const {
+    if (empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (!buffer_.empty()) {
+        QuantileSketch compressed(*this);
+        compressed.compress();
+        return compressed.quantile(q);
+    }
+
+    q = std::min(std::max(q, 0.0), 1.0);
+    if (q == 0.0) {
+        return min_;
+    }
+    if (q == 1.0) {
+        return max_;
+    }
+    if (centroids_.size() == 1) {
+        return centroids_[0].mean;
+    }
+
+    const double rank = q * static_cast<double>(count_);
+
+    // Left tail: from the minimum to the first centre
+    const Centroid& first = centroids_.front();
+    if (rank < first.weight / 2) {
+        return min_ + (first.mean - min_) * rank / (first.weight / 2);
+    }
+
+    double cumulative = first.weight / 2;
+    for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+        double step = (centroids_[i].weight + centroids_[i + 1].weight) / 2;
+        if (rank < cumulative + step) {
+            double t = (rank - cumulative) / step;
+            return centroids_[i].mean + (centroids_[i + 1].mean - centroids_[i].mean) * t;
+        }
+        cumulative += step;
+    }
+
+    // Right tail: from the last centre to the maximum
+    const Centroid& last = centroids_.back();
+    double t = std::min((rank - cumulative) / (last.weight / 2), 1.0);
+    return last.mean + (max_ - last.mean) * t;
+}
@@ -0,0 +1,660 @@
+#include "QueryEngine.h"
+#include "CandleView.h"
+#include "ColumnAggregation.h"
+#include "Correlation.h"
+#include "DateTime.h"
+#include "Indicators.h"
+#include "Instrumentation.h"
+#include "Regression.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::vector<std::string> tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::istringstream stream(text);
+    std::string token;
+    while (stream >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+double parseNumber(const std::string& text) {
+    try {
+        size_t used = 0;
+        double value = std::stod(text, &used);
+        if (used == text.size()) {
+            return value;
+        }
+    } catch (const std::exception&) {
+    }
+    throw std::runtime_error("Invalid number: " + text);
+}
+
+int64_t parseTime(const std::string& text, bool end_of_day) {
+    int64_t epoch = 0;
+    if (!parseTimestamp(text, epoch)) {
+        throw std::runtime_error("Invalid timestamp: " + text);
+    }
+    if (end_of_day && text.size() == 10) {
+        epoch += 86399; // A date-only end covers the whole day
+    }
+    return epoch;
+}
+
+void requireArguments(const std::vector<std::string>& tokens, size_t count, const char* usage) {
+    if (tokens.size() < count) {
+        throw std::runtime_error(std::string("Usage: ") + usage);
+    }
+}
+
+/**
+ * Removes an optional "width <columns>" clause, returning 0 if there is none.
+ */
+size_t takeWidth(std::vector<std::string>& tokens, size_t first) {
+    for (size_t i = first; i + 1 < tokens.size(); ++i) {
+        if (tokens[i] == "width") {
+            double width = parseNumber(tokens[i + 1]);
+            if (width < 1) {
+                throw std::runtime_error("Invalid width: " + tokens[i + 1]);
+            }
+            tokens.erase(tokens.begin() + i, tokens.begin() + i + 2);
+            return static_cast<size_t>(width);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Removes every "overlay <indicator>" clause, returning the indicators in order.
+ */
+std::vector<IndicatorSpec> takeOverlays(std::vector<std::string>& tokens, size_t first) {
+    std::vector<IndicatorSpec> specs;
+    for (size_t i = first; i < tokens.size();) {
+        if (tokens[i] == "overlay" && i + 1 < tokens.size()) {
+            specs.push_back(parseIndicator(tokens[i + 1]));
+            tokens.erase(tokens.begin() + i, tokens.begin() + i + 2);
+        } else {
+            ++i;
+        }
+    }
+    return specs;
+}
+
+/**
+ * Applies the optional "dates <from> <to>" and "temps <lo> <hi>" clauses.
+ */
+void applyFilters(const std::vector<std::string>& tokens, size_t first, CandleView& view) {
+    for (size_t i = first; i < tokens.size(); i += 3) {
+        if (i + 2 >= tokens.size()) {
+            throw std::runtime_error("Incomplete filter: " + tokens[i]);
+        }
+        if (tokens[i] == "dates") {
+            view.dateRange(tokens[i + 1], tokens[i + 2]);
+        } else if (tokens[i] == "temps") {
+            view.temperatureRange(parseNumber(tokens[i + 1]), parseNumber(tokens[i + 2]));
+        } else {
+            throw std::runtime_error("Unknown filter: " + tokens[i]);
+        }
+    }
+}
+
+/**
+ * Parses a whole number in [min, max].
+ */
+int parseInteger(const std::string& text, int min, int max) {
+    double value = parseNumber(text);
+    if (value != std::floor(value) || value < min || value > max) {
+        throw std::runtime_error("Invalid value: " + text);
+    }
+    return static_cast<int>(value);
+}
+
+/**
+ * Restores a stream's formatting state on scope exit, also when a query throws
+ * halfway through its report.
+ */
+class StreamFormatGuard {
+public:
+    explicit StreamFormatGuard(std::ostream& out) : out_(out), saved_(nullptr) { saved_.copyfmt(out); }
+    ~StreamFormatGuard() { out_.copyfmt(saved_); }
+
+    StreamFormatGuard(const StreamFormatGuard&) = delete;
+    StreamFormatGuard& operator=(const StreamFormatGuard&) = delete;
+
+private:
+    std::ostream& out_;
+    std::ios saved_;
+};
+
+/**
+ * Expands "predict-sweep [<CC>...] [windows <from>-<to>...] [degrees <d>...]
+ * [horizon <n>]" into one job per (country, window, degree). No countries
+ * means every country; no windows means each country's whole history.
+ * job_windows receives each job's window as written ("all" for the default).
+ */
+std::vector<RegressionJob> parseSweep(const std::vector<std::string>& tokens, const WeatherTable& table,
+                                      std::vector<std::string>& job_windows) {
+    std::vector<std::string> countries;
+    std::vector<std::string> window_names;
+    std::vector<std::pair<int, int>> windows;
+    std::vector<int> degrees;
+    int horizon = 3;
+
+    std::string clause;
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        const std::string& token = tokens[i];
+        if (token == "windows" || token == "degrees" || token == "horizon") {
+            clause = token;
+        } else if (clause.empty()) {
+            countries.push_back(token);
+        } else if (clause == "windows") {
+            size_t dash = token.find('-', 1);
+            if (dash == std::string::npos) {
+                throw std::runtime_error("Invalid window (expected <from>-<to>): " + token);
+            }
+            windows.emplace_back(parseInteger(token.substr(0, dash), -9999, 9999),
+                                 parseInteger(token.substr(dash + 1), -9999, 9999));
+            window_names.push_back(token);
+        } else if (clause == "degrees") {
+            degrees.push_back(parseInteger(token, 0, 10));
+        } else {
+            horizon = parseInteger(token, 1, 100);
+        }
+    }
+    if (countries.empty()) {
+        countries = table.countryPrefixes();
+    }
+    if (windows.empty()) {
+        windows.emplace_back(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+        window_names.push_back("all");
+    }
+    if (degrees.empty()) {
+        degrees.push_back(2);
+    }
+
+    std::vector<RegressionJob> jobs;
+    for (const auto& country : countries) {
+        for (size_t w = 0; w < windows.size(); ++w) {
+            for (int degree : degrees) {
+                jobs.push_back({country, windows[w].first, windows[w].second, degree, horizon});
+                job_windows.push_back(window_names[w]);
+            }
+        }
+    }
+    return jobs;
+}
+
+/**
+ * One row per predicted year; a job that could not run has one row with its error.
+ */
+void writeSweepCsv(const std::vector<RegressionResult>& results, const std::vector<std::string>& job_windows,
+                   std::ostream& out) {
+    out << "country,window,degree,samples,rms_error,year,prediction,error\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RegressionResult& result = results[i];
+        auto writeJob = [&]() {
+            out << result.job.country_prefix << ',' << job_windows[i] << ',' << result.job.degree;
+        };
+        if (!result.error.empty()) {
+            writeJob();
+            out << ",,,,," << result.error << '\n';
+            continue;
+        }
+        for (size_t p = 0; p < result.predictions.size(); ++p) {
+            writeJob();
+            out << ',' << result.fit.samples << ',' << result.fit.rms_error << ',' << result.predict_years[p] << ','
+                << result.predictions[p] << ",\n";
+        }
+    }
+}
+
+void writeCandlesCsv(const CandleView& view, std::ostream& out) {
+    out << "date,open,high,low,close\n";
+    for (const auto& candle : view) {
+        out << candle.date << ',' << candle.open << ',' << candle.high << ','
+            << candle.low << ',' << candle.close << '\n';
+    }
+}
+
+void writeIndicatorsCsv(const std::vector<Candlestick>& candlesticks, const CandleIndicators& indicators,
+                        std::ostream& out) {
+    out << "date,close";
+    for (size_t s = 0; s < indicators.seriesCount(); ++s) {
+        out << ',' << indicators.seriesName(s);
+    }
+    out << '\n';
+    for (size_t i = 0; i < candlesticks.size(); ++i) {
+        out << candlesticks[i].date << ',' << candlesticks[i].close;
+        for (size_t s = 0; s < indicators.seriesCount(); ++s) {
+            out << ',';
+            double value = indicators.series(s)[i];
+            if (!std::isnan(value)) {
+                out << value;
+            }
+        }
+        out << '\n';
+    }
+}
+
+void writeOverlayLegend(const CandleIndicators& indicators, std::ostream& out) {
+    out << "Overlays:";
+    for (size_t s = 0; s < indicators.seriesCount(); ++s) {
+        if (indicators.seriesGlyph(s) != 0) {
+            out << "  " << indicators.seriesGlyph(s) << ' ' << indicators.seriesName(s);
+        }
+    }
+    out << '\n';
+}
+
+void writeMatrixCsv(const CorrelationMatrix& matrix, const std::vector<double>& values, std::ostream& out) {
+    out << "column";
+    for (const auto& label : matrix.labels) {
+        out << ',' << label;
+    }
+    out << '\n';
+    for (size_t row = 0; row < matrix.size(); ++row) {
+        out << matrix.labels[row];
+        for (size_t column = 0; column < matrix.size(); ++column) {
+            out << ',';
+            double value = values[matrix.index(row, column)];
+            if (!std::isnan(value)) {
+                out << value;
+            }
+        }
+        out << '\n';
+    }
+}
+
+void writeAggregatesCsv(const ColumnAggregates& aggregates, std::ostream& out) {
+    out << "column,date,count,open,high,low,close,sum,mean,variance\n";
+    for (size_t c = 0; c < aggregates.columnCount(); ++c) {
+        for (size_t b = 0; b < aggregates.bucketCount(); ++b) {
+            size_t slot = aggregates.index(c, b);
+            if (aggregates.count[slot] == 0) {
+                continue;
+            }
+            out << aggregates.column_names[c] << ',' << aggregates.labels[b] << ',' << aggregates.count[slot] << ','
+                << aggregates.open[slot] << ',' << aggregates.high[slot] << ',' << aggregates.low[slot] << ','
+                << aggregates.close[slot] << ',' << aggregates.sum[slot] << ',' << aggregates.mean[slot] << ',';
+            if (aggregates.count[slot] > 1) {
+                out << aggregates.variance(c, b);
+            }
+            out << '\n';
+        }
+    }
+}
+
+void writeQuantilesCsv(const CandleQuantiles& quantiles, std::ostream& out) {
+    out << "date";
+    for (double probability : quantiles.probabilities) {
+        std::ostringstream name;
+        name << 'p' << probability * 100;
+        out << ',' << name.str();
+    }
+    out << '\n';
+    for (size_t i = 0; i < quantiles.dates.size(); ++i) {
+        out << quantiles.dates[i];
+        for (size_t p = 0; p < quantiles.probabilities.size(); ++p) {
+            out << ',' << quantiles.value(i, p);
+        }
+        out << '\n';
+    }
+}
+
+} // namespace
+
+// --- QueryEngine ---
+
+QueryEngine::QueryEngine(const WeatherTable& table, std::map<std::string, OnlineForecaster> forecaster_state)
+    : table_(table), saved_forecasters_(std::move(forecaster_state)) {}
+
+/**
+ * Looks up or computes the candle series for a country and frame. Day and
+ * coarser frames are read from the country's rollup, so every such frame
+ * shares one pass over the hourly column.
+ *
+ * @param country_prefix The country prefix.
+ * @param time_frame The bucket size.
+ * @return The cached series.
+ */
+const std::vector<Candlestick>& QueryEngine::candles(const std::string& country_prefix,
+                                                     const TimeFrameSpec& time_frame) {
+    auto key = std::make_pair(country_prefix, timeFrameName(time_frame));
+    {
+        std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+        auto it = candles_.find(key);
+        if (it != candles_.end()) {
+            return it->second;
+        }
+    }
+
+    // Compute outside the lock; if another thread got there first, keep its copy.
+    std::vector<Candlestick> series = CandleRollup::hasLevel(time_frame)
+                                          ? rollup(country_prefix, false).candles(time_frame)
+                                          : computeCandlestickData(table_, country_prefix, time_frame);
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    return candles_.emplace(key, std::move(series)).first->second;
+}
+
+/**
+ * Looks up or builds the range index for a country.
+ *
+ * @param country_prefix The country prefix.
+ * @return The cached index.
+ */
+const RangeQueryIndex& QueryEngine::rangeIndex(const std::string& country_prefix) {
+    {
+        std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+        auto it = range_indexes_.find(country_prefix);
+        if (it != range_indexes_.end()) {
+            return *it->second;
+        }
+    }
+
+    auto index = std::make_unique<RangeQueryIndex>(table_, country_prefix);
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    return *range_indexes_.emplace(country_prefix, std::move(index)).first->second;
+}
+
+/**
+ * Looks up or builds the interval index over a cached candle series.
+ *
+ * @param country_prefix The country prefix.
+ * @param time_frame The bucket size.
+ * @return The cached index.
+ */
+const TemperatureIntervalIndex& QueryEngine::bandIndex(const std::string& country_prefix,
+                                                       const TimeFrameSpec& time_frame) {
+    auto key = std::make_pair(country_prefix, timeFrameName(time_frame));
+    {
+        std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+        auto it = band_indexes_.find(key);
+        if (it != band_indexes_.end()) {
+            return *it->second;
+        }
+    }
+
+    auto index = std::make_unique<TemperatureIntervalIndex>(candles(country_prefix, time_frame));
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    return *band_indexes_.emplace(key, std::move(index)).first->second;
+}
+
+/**
+ * Looks up or builds the rollup for a country. A sketched rollup also serves
+ * candle requests, so a plain one is only built while none exists.
+ *
+ * @param country_prefix The country prefix.
+ * @param with_quantiles Whether quantile sketches are needed.
+ * @return The cached rollup.
+ */
+const CandleRollup& QueryEngine::rollup(const std::string& country_prefix, bool with_quantiles) {
+    auto& cache = with_quantiles ? sketched_rollups_ : rollups_;
+    {
+        std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+        auto sketched = sketched_rollups_.find(country_prefix);
+        if (sketched != sketched_rollups_.end()) {
+            return *sketched->second;
+        }
+        auto it = cache.find(country_prefix);
+        if (it != cache.end()) {
+            return *it->second;
+        }
+    }
+
+    auto built = std::make_unique<CandleRollup>(table_, country_prefix, with_quantiles);
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    return *cache.emplace(country_prefix, std::move(built)).first->second;
+}
+
+/**
+ * Looks up the forecaster for a country, or starts from its saved state (if
+ * any) and folds in the table's newer rows.
+ *
+ * @param country_prefix The country prefix.
+ * @return The cached, up-to-date forecaster.
+ */
+const OnlineForecaster& QueryEngine::forecaster(const std::string& country_prefix) {
+    {
+        std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+        auto it = forecasters_.find(country_prefix);
+        if (it != forecasters_.end()) {
+            return *it->second;
+        }
+    }
+
+    std::map<std::string, OnlineForecaster> state;
+    auto saved = saved_forecasters_.find(country_prefix);
+    if (saved != saved_forecasters_.end()) {
+        state.insert(*saved);
+    }
+    auto updated = std::make_unique<OnlineForecaster>(updateForecaster(state, table_, country_prefix, 2));
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    return *forecasters_.emplace(country_prefix, std::move(updated)).first->second;
+}
+
+/**
+ * Copies the forecasters under the read lock.
+ *
+ * @return Forecasters keyed by country prefix.
+ */
+std::map<std::string, OnlineForecaster> QueryEngine::forecasterState() {
+    std::map<std::string, OnlineForecaster> state = saved_forecasters_;
+    std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+    for (const auto& [country, forecaster] : forecasters_) {
+        state.insert_or_assign(country, *forecaster);
+    }
+    return state;
+}
+
+/**
+ * Dispatches one query. The stream's formatting state is restored afterwards,
+ * even if the query fails, since the plot and prediction reports leave it in
+ * fixed-point mode.
+ *
+ * @param query The query text.
+ * @param out The stream to write the result to.
+ */
+void QueryEngine::execute(const std::string& query, std::ostream& out) {
+    std::vector<std::string> tokens = tokenize(query);
+    if (tokens.empty()) {
+        return;
+    }
+
+    ScopedTimer timer("query");
+    StreamFormatGuard format_guard(out);
+
+    const std::string& command = tokens[0];
+    if (command == "candles" || command == "filter" || command == "plot") {
+        requireArguments(tokens, 3, "candles|filter|plot <CC> <frame> [dates <from> <to>] [temps <lo> <hi>] "
+                                    "[width <columns>] [overlay <indicator>]...");
+        if (command == "candles" && tokens.size() > 3) {
+            throw std::runtime_error("candles takes no filters; use filter");
+        }
+        size_t width = command == "plot" ? takeWidth(tokens, 3) : 0;
+        std::vector<IndicatorSpec> overlay_specs;
+        if (command == "plot") {
+            overlay_specs = takeOverlays(tokens, 3);
+        }
+        TimeFrameSpec time_frame = parseTimeFrame(tokens[2]);
+        const std::vector<Candlestick>& series = candles(tokens[1], time_frame);
+        CandleView view(series, tokens[1]);
+        if (std::find(tokens.begin() + 3, tokens.end(), "temps") != tokens.end()) {
+            view.bandIndex(bandIndex(tokens[1], time_frame));
+        }
+        applyFilters(tokens, 3, view);
+
+        if (command == "plot") {
+            // Indicators see the whole series, so the first plotted candles are already warmed up
+            std::vector<Candlestick> filtered;
+            CandleIndicators indicators(overlay_specs, series);
+            std::vector<PlotOverlay> overlays = indicators.overlays();
+            std::vector<PlotOverlay> visible;
+            for (const auto& overlay : overlays) {
+                visible.push_back({{}, overlay.glyph});
+            }
+            for (auto it = view.begin(); it != view.end(); ++it) {
+                filtered.push_back(*it);
+                for (size_t o = 0; o < overlays.size(); ++o) {
+                    visible[o].values.push_back(overlays[o].values[it.position()]);
+                }
+            }
+
+            if (filtered.empty()) {
+                out << "No data available for the selected filter.\n";
+            } else {
+                if (!overlays.empty()) {
+                    writeOverlayLegend(indicators, out);
+                }
+                plotGroupedCandlesticks(filtered, 20, out, width, visible);
+            }
+        } else {
+            writeCandlesCsv(view, out);
+        }
+    } else if (command == "predict") {
+        size_t width = takeWidth(tokens, 4);
+        requireArguments(tokens, 4, "predict <CC> <start_year> <end_year> [width <columns>]");
+        int start_year = parseInteger(tokens[2], -9999, 9999);
+        int end_year = parseInteger(tokens[3], -9999, 9999);
+        displayTemperaturePrediction(candles(tokens[1], TimeFrame::Year), tokens[1], start_year, end_year, out,
+                                     width, &forecaster(tokens[1]));
+    } else if (command == "predict-sweep") {
+        std::vector<std::string> job_windows;
+        std::vector<RegressionJob> jobs = parseSweep(tokens, table_, job_windows);
+        writeSweepCsv(runRegressionBatch(table_, jobs), job_windows, out);
+    } else if (command == "range") {
+        requireArguments(tokens, 4, "range <CC> <start> <end>");
+        RangeSummary summary = rangeIndex(tokens[1]).query(parseTime(tokens[2], false), parseTime(tokens[3], true));
+        out << "country,start,end,count,open,high,low,close\n";
+        out << tokens[1] << ',' << tokens[2] << ',' << tokens[3] << ',' << summary.count;
+        if (summary.empty()) {
+            out << ",,,,\n";
+        } else {
+            out << ',' << summary.open << ',' << summary.high << ',' << summary.low << ',' << summary.close << '\n';
+        }
+    } else if (command == "aggregate") {
+        requireArguments(tokens, 2, "aggregate <frame> [<column>|<CC>]...");
+        std::vector<std::string> selectors(tokens.begin() + 2, tokens.end());
+        writeAggregatesCsv(aggregateColumns(table_, parseTimeFrame(tokens[1]), selectColumns(table_, selectors)), out);
+    } else if (command == "indicators") {
+        requireArguments(tokens, 4, "indicators <CC> <frame> <indicator>...");
+        std::vector<IndicatorSpec> specs;
+        for (size_t i = 3; i < tokens.size(); ++i) {
+            specs.push_back(parseIndicator(tokens[i]));
+        }
+        const std::vector<Candlestick>& series = candles(tokens[1], parseTimeFrame(tokens[2]));
+        writeIndicatorsCsv(series, CandleIndicators(specs, series), out);
+    } else if (command == "correlation" || command == "covariance" || command == "heatmap") {
+        std::vector<std::string> selectors(tokens.begin() + 1, tokens.end());
+        CorrelationMatrix matrix = correlateColumns(table_, selectCorrelationColumns(table_, selectors));
+        if (command == "heatmap") {
+            out << renderCorrelationHeatmap(matrix);
+        } else {
+            writeMatrixCsv(matrix, command == "correlation" ? matrix.correlation : matrix.covariance, out);
+        }
+    } else if (command == "quantiles") {
+        requireArguments(tokens, 3, "quantiles <CC> <frame> [<probability>...]");
+        std::vector<double> probabilities;
+        for (size_t i = 3; i < tokens.size(); ++i) {
+            double probability = parseNumber(tokens[i]);
+            if (!(probability >= 0.0 && probability <= 1.0)) {
+                throw std::runtime_error("Probability out of [0, 1]: " + tokens[i]);
+            }
+            probabilities.push_back(probability);
+        }
+        if (probabilities.empty()) {
+            probabilities = {0.05, 0.5, 0.95};
+        }
+        TimeFrameSpec time_frame = parseTimeFrame(tokens[2]);
+        writeQuantilesCsv(rollup(tokens[1], true).quantiles(time_frame, probabilities), out);
+    } else {
+        throw std::runtime_error("Unknown query: " + command);
+    }
+}
+
+/**
+ * Runs each query, sending its output to the default stream or its "> file" target.
+ *
+ * @param queries The queries to run.
+ * @param out The default output stream.
+ * @return The number of failed queries.
+ */
+size_t QueryEngine::runBatch(const std::vector<std::string>& queries, std::ostream& out) {
+    size_t failures = 0;
+    for (const auto& line : queries) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+
+        std::string query = line;
+        std::string target;
+        size_t redirect = line.rfind('>');
+        if (redirect != std::string::npos) {
+            query = line.substr(0, redirect);
+            std::vector<std::string> names = tokenize(line.substr(redirect + 1));
+            if (names.size() == 1) {
+                target = names[0];
+            } else {
+                std::cerr << "Error: expected one file name after '>' in: " << line << "\n";
+                ++failures;
+                continue;
+            }
+        }
+
+        try {
+            if (target.empty()) {
+                execute(query, out);
+            } else {
+                std::ofstream file(target);
+                if (!file.is_open()) {
+                    throw std::runtime_error("Could not open output file: " + target);
+                }
+                execute(query, file);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << " (query: " << line << ")\n";
+            ++failures;
+        }
+    }
+    out.flush();
+    return failures;
+}
+
+// --- Query files ---
+
+/**
+ * Reads one query per line.
+ *
+ * @param filename The file to read, or "-" for standard input.
+ * @return The lines of the file.
+ */
+std::vector<std::string> readQueryFile(const std::string& filename) {
+    std::vector<std::string> queries;
+    std::string line;
+    if (filename == "-") {
+        while (std::getline(std::cin, line)) {
+            queries.push_back(line);
+        }
+        return queries;
+    }
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open query file: " + filename);
+    }
+    while (std::getline(file, line)) {
+        queries.push_back(line);
+    }
+    return queries;
+}
@@ -0,0 +1,139 @@
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#include "CandleRollup.h"
+#include "Candlestick.h"
+#include "OnlineForecaster.h"
+#include "RangeQueryIndex.h"
+#include "TemperatureIntervalIndex.h"
+#include "TimeFrame.h"
+#include "WeatherTable.h"
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Runs text queries against a loaded table, for scripted and batch use.
+ *
+ * One query per line; tokens are separated by whitespace:
+ *
+ *   candles <CC> <frame>                                  every candle, as CSV
+ *   filter  <CC> <frame> [dates <from> <to>] [temps <lo> <hi>]  filtered candles, as CSV
+ *   plot    <CC> <frame> [dates <from> <to>] [temps <lo> <hi>] [width <columns>] [overlay <indicator>]...
+ *                                                         grouped text plot
+ *   predict <CC> <start_year> <end_year> [width <columns>]  same report as the interactive menu
+ *   predict-sweep [<CC>...] [windows <from>-<to>...] [degrees <d>...] [horizon <n>]
+ *                                                         one fit per (country, window, degree), as CSV
+ *   range   <CC> <start> <end>                            OHLC of the raw readings in [start, end]
+ *   aggregate <frame> [<column>|<CC>]...                  OHLC, count, sum, mean and variance
+ *                                                         of each column per bucket, as CSV
+ *   indicators <CC> <frame> <indicator>...                close and indicator series per candle, as CSV
+ *   correlation [<CC>|<column>]...                        pairwise Pearson correlation matrix, as CSV
+ *   covariance  [<CC>|<column>]...                        pairwise sample covariance matrix, as CSV
+ *   heatmap     [<CC>|<column>]...                        correlation matrix as a text heatmap
+ *   quantiles <CC> <frame> [<p>...]                       estimated quantiles of each candle, as CSV
+ *                                                         (default p: 0.05 0.5 0.95)
+ *
+ * <frame> is anything parseTimeFrame accepts ("year", "month", "6h", ...).
+ * Range bounds are timestamps; a date-only end ("2003-08-20") covers that
+ * whole day. Aggregate selectors are full column names or country prefixes
+ * (every column of that country); none aggregates every column. Quantiles
+ * come from t-digest sketches merged up the candle rollup (see CandleRollup).
+ * Correlation selectors are country prefixes (that country's temperature) or
+ * full column names; none selects every country. Each pair is computed over
+ * the hours where both columns have a reading (see correlateColumns).
+ * An <indicator> is "sma20", "ema12", "bb20", "atr14" or "donchian20" (see
+ * CandleIndicators); it is computed over the whole series before filtering.
+ * Plots wider than "width" (default: the terminal width) are decimated to
+ * fit. Any query may end with "> <file>" to write its output to a file
+ * instead of the default stream. Blank lines and lines starting with '#' are
+ * ignored.
+ *
+ * A "temps" band is answered from an interval index over the candle series
+ * (see TemperatureIntervalIndex) rather than by scanning it.
+ *
+ * predict-sweep runs its fits in parallel (see runRegressionBatch); no
+ * countries means every country, no windows each country's whole history, and
+ * the defaults are degree 2 and a 3-year horizon. A job that cannot run (e.g.
+ * an empty window) reports its error in the last column.
+ *
+ * Day and coarser candle series are read from a per-country CandleRollup, so
+ * switching between those frames never rescans the hourly data. "predict"
+ * keeps an OnlineForecaster per country; a report whose window spans the
+ * country's whole history reads the running fit instead of refitting.
+ *
+ * Candle series, range, band indexes and rollups are computed on first use and
+ * reused by later queries. The table is never modified and the caches only
+ * grow, so execute() may be called from several threads at once. Lookups
+ * share a read lock; only the first use of a series takes the write lock. The table must
+ * outlive the engine.
+ */
+class QueryEngine {
+public:
+    /**
+     * @param table The loaded table.
+     * @param forecaster_state Saved forecasters (see loadForecasters); each is brought up to
+     *                         date with the table's newer rows on first use.
+     */
+    explicit QueryEngine(const WeatherTable& table, std::map<std::string, OnlineForecaster> forecaster_state = {});
+
+    /**
+     * @brief Runs one query.
+     *
+     * @param query The query text, without a "> file" redirect.
+     * @param out The stream to write the result to.
+     * @throws std::runtime_error if the query is malformed or names an unknown country or frame.
+     */
+    void execute(const std::string& query, std::ostream& out);
+
+    /**
+     * @brief Runs a list of queries, honouring "> file" redirects.
+     *
+     * A failing query reports "Error: ..." on std::cerr and the batch carries on.
+     *
+     * @param queries The queries to run, in order.
+     * @param out The default output stream.
+     * @return The number of queries that failed.
+     */
+    size_t runBatch(const std::vector<std::string>& queries, std::ostream& out);
+
+    /**
+     * @brief Returns the candle series for a country and frame, computing it on first use.
+     */
+    const std::vector<Candlestick>& candles(const std::string& country_prefix, const TimeFrameSpec& time_frame);
+
+    /**
+     * @brief Returns the forecasters used so far plus any saved ones not yet used, for saveForecasters.
+     */
+    std::map<std::string, OnlineForecaster> forecasterState();
+
+private:
+    const OnlineForecaster& forecaster(const std::string& country_prefix);
+    const RangeQueryIndex& rangeIndex(const std::string& country_prefix);
+    const TemperatureIntervalIndex& bandIndex(const std::string& country_prefix, const TimeFrameSpec& time_frame);
+    const CandleRollup& rollup(const std::string& country_prefix, bool with_quantiles);
+
+    const WeatherTable& table_;
+    std::shared_mutex cache_mutex_;  // Guards every cache below; entries are never erased.
+    std::map<std::pair<std::string, std::string>, std::vector<Candlestick>> candles_;
+    std::map<std::string, std::unique_ptr<RangeQueryIndex>> range_indexes_;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<TemperatureIntervalIndex>> band_indexes_;
+    std::map<std::string, std::unique_ptr<CandleRollup>> rollups_;          // Candles only.
+    std::map<std::string, std::unique_ptr<CandleRollup>> sketched_rollups_; // Candles and quantiles.
+    std::map<std::string, std::unique_ptr<OnlineForecaster>> forecasters_;
+    const std::map<std::string, OnlineForecaster> saved_forecasters_; // As loaded; never modified.
+};
+
+/**
+ * @brief Reads queries from a file, one per line ("-" reads standard input).
+ *
+ * @throws std::runtime_error if the file cannot be opened.
+ */
+std::vector<std::string> readQueryFile(const std::string& filename);
+
+#endif // QUERY_ENGINE_H
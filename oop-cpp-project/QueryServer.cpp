@@ -0,0 +1,409 @@
+#include "QueryServer.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+const SocketHandle kInvalidSocket = INVALID_SOCKET;
+void closeSocket(SocketHandle socket) { closesocket(socket); }
+#else
+using SocketHandle = int;
+const SocketHandle kInvalidSocket = -1;
+void closeSocket(SocketHandle socket) { close(socket); }
+#endif
+
+const size_t kMaxHeaderBytes = 64 * 1024;
+const size_t kMaxBodyBytes = 1024 * 1024;
+
+std::atomic<bool> stop_requested(false);
+
+extern "C" void requestStop(int) {
+    stop_requested = true;
+}
+
+// --- Request parsing ---
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Decodes application/x-www-form-urlencoded text ('+' is a space, %XX a byte).
+ */
+std::string urlDecode(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '+') {
+            result += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+            result += static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+            i += 2;
+        } else {
+            result += text[i];
+        }
+    }
+    return result;
+}
+
+/**
+ * Collects every "q" parameter of a query string.
+ */
+std::vector<std::string> queryParameters(const std::string& query_string) {
+    std::vector<std::string> queries;
+    std::istringstream stream(query_string);
+    std::string pair;
+    while (std::getline(stream, pair, '&')) {
+        size_t equals = pair.find('=');
+        if (equals != std::string::npos && pair.compare(0, equals, "q") == 0) {
+            queries.push_back(urlDecode(pair.substr(equals + 1)));
+        }
+    }
+    return queries;
+}
+
+const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        default: return "Error";
+    }
+}
+
+// --- Connections ---
+
+bool sendAll(SocketHandle socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+#ifdef _WIN32
+        int count = send(socket, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+#else
+        ssize_t count = send(socket, data.data() + sent, data.size() - sent, 0);
+#endif
+        if (count <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+void sendResponse(SocketHandle socket, int status, const std::string& body) {
+    std::ostringstream response;
+    response << "HTTP/1.0 " << status << ' ' << statusText(status) << "\r\n"
+             << "Content-Type: text/plain; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    sendAll(socket, response.str());
+}
+
+/**
+ * Reads one request, answers it and closes the connection.
+ */
+void handleConnection(QueryEngine& engine, SocketHandle socket) {
+    std::string request;
+    size_t header_end = std::string::npos;
+    size_t content_length = 0;
+    char buffer[8192];
+
+    for (;;) {
+        if (header_end != std::string::npos && request.size() >= header_end + 4 + content_length) {
+            break;
+        }
+        int count = static_cast<int>(recv(socket, buffer, sizeof(buffer), 0));
+        if (count <= 0) {
+            closeSocket(socket);
+            return; // Client went away or timed out mid-request
+        }
+        request.append(buffer, static_cast<size_t>(count));
+
+        if (header_end == std::string::npos) {
+            header_end = request.find("\r\n\r\n");
+            if (header_end == std::string::npos) {
+                if (request.size() > kMaxHeaderBytes) {
+                    sendResponse(socket, 413, "Request header too large\n");
+                    closeSocket(socket);
+                    return;
+                }
+                continue;
+            }
+
+            // Header names are case-insensitive; only Content-Length matters here.
+            std::string header = request.substr(0, header_end);
+            for (auto& c : header) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            size_t field = header.find("\r\ncontent-length:");
+            if (field != std::string::npos) {
+                content_length = std::strtoul(header.c_str() + field + 17, nullptr, 10);
+            }
+            if (content_length > kMaxBodyBytes) {
+                sendResponse(socket, 413, "Request body too large\n");
+                closeSocket(socket);
+                return;
+            }
+        }
+    }
+
+    std::istringstream request_line(request.substr(0, request.find("\r\n")));
+    std::string method, target;
+    request_line >> method >> target;
+
+    std::string body_out;
+    int status = handleQueryRequest(engine, method, target, request.substr(header_end + 4, content_length), body_out);
+    sendResponse(socket, status, body_out);
+    closeSocket(socket);
+}
+
+/**
+ * Opens the loopback TCP or Unix socket listener.
+ */
+SocketHandle openListener(const ServerOptions& options) {
+    SocketHandle listener = kInvalidSocket;
+    if (!options.unix_socket.empty()) {
+#ifdef _WIN32
+        std::cerr << "Error: Unix sockets are not supported on this platform; use --serve PORT.\n";
+        return kInvalidSocket;
+#else
+        sockaddr_un address{};
+        if (options.unix_socket.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Error: Unix socket path is too long: " << options.unix_socket << "\n";
+            return kInvalidSocket;
+        }
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, options.unix_socket.c_str());
+
+        // Remove a socket left by a previous run, but never anything else
+        struct stat existing{};
+        if (lstat(options.unix_socket.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                std::cerr << "Error: " << options.unix_socket << " exists and is not a socket\n";
+                return kInvalidSocket;
+            }
+            unlink(options.unix_socket.c_str());
+        }
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener == kInvalidSocket ||
+            bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "Error: Could not bind Unix socket " << options.unix_socket << "\n";
+            if (listener != kInvalidSocket) closeSocket(listener);
+            return kInvalidSocket;
+        }
+#endif
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(options.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (listener != kInvalidSocket) {
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        }
+        if (listener == kInvalidSocket ||
+            bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "Error: Could not bind 127.0.0.1:" << options.port << "\n";
+            if (listener != kInvalidSocket) closeSocket(listener);
+            return kInvalidSocket;
+        }
+    }
+
+    if (listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "Error: Could not listen for connections\n";
+        closeSocket(listener);
+        return kInvalidSocket;
+    }
+    return listener;
+}
+
+void installStopHandlers() {
+#ifdef _WIN32
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+#else
+    // No SA_RESTART, so a blocked accept() returns EINTR and the loop sees the flag.
+    struct sigaction action{};
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN); // A client hanging up must not kill the server
+#endif
+}
+
+} // namespace
+
+// --- Request handling ---
+
+/**
+ * Routes one request to the engine.
+ *
+ * @param engine The shared engine.
+ * @param method The HTTP method.
+ * @param target The request target.
+ * @param body The request body.
+ * @param body_out Receives the response body.
+ * @return The HTTP status code.
+ */
+int handleQueryRequest(QueryEngine& engine, const std::string& method, const std::string& target,
+                       const std::string& body, std::string& body_out) {
+    size_t question = target.find('?');
+    std::string path = target.substr(0, question);
+
+    if (path == "/health") {
+        body_out = "ok\n";
+        return 200;
+    }
+    if (path != "/query") {
+        body_out = "Not found: " + path + "\n";
+        return 404;
+    }
+
+    std::vector<std::string> queries;
+    if (method == "GET") {
+        if (question != std::string::npos) {
+            queries = queryParameters(target.substr(question + 1));
+        }
+    } else if (method == "POST") {
+        std::istringstream lines(body);
+        std::string line;
+        while (std::getline(lines, line)) {
+            queries.push_back(line);
+        }
+    } else {
+        body_out = "Method not allowed: " + method + "\n";
+        return 405;
+    }
+
+    std::ostringstream out;
+    bool failed = false;
+    for (const auto& query : queries) {
+        try {
+            engine.execute(query, out);
+        } catch (const std::exception& e) {
+            out << "Error: " << e.what() << " (query: " << query << ")\n";
+            failed = true;
+        }
+    }
+    body_out = out.str();
+    return failed ? 400 : 200;
+}
+
+// --- Server loop ---
+
+/**
+ * Accepts connections and hands them to the pool until asked to stop.
+ *
+ * @param engine The shared engine.
+ * @param options The listener and pool settings.
+ * @return The process exit code.
+ */
+int serveQueries(QueryEngine& engine, const ServerOptions& options) {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        std::cerr << "Error: Could not initialise Winsock\n";
+        return 1;
+    }
+#endif
+
+    SocketHandle listener = openListener(options);
+    if (listener == kInvalidSocket) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return 1;
+    }
+
+    installStopHandlers();
+    {
+        ThreadPool pool(options.workers);
+        if (options.unix_socket.empty()) {
+            std::cout << "Serving queries on http://127.0.0.1:" << options.port << "/query";
+        } else {
+            std::cout << "Serving queries on unix:" << options.unix_socket;
+        }
+        std::cout << " with " << pool.size() << " workers (Ctrl+C to stop)" << std::endl;
+
+        while (!stop_requested) {
+            SocketHandle client = accept(listener, nullptr, nullptr);
+            if (client == kInvalidSocket) {
+                if (stop_requested) {
+                    break;
+                }
+#ifdef _WIN32
+                int error = WSAGetLastError();
+                bool fatal = error == WSAENOTSOCK || error == WSAEINVAL;
+#else
+                int error = errno;
+                if (error == EINTR) {
+                    continue;
+                }
+                bool fatal = error == EBADF || error == ENOTSOCK || error == EINVAL;
+#endif
+                // Aborted connections and running out of descriptors pass; only a broken listener stops the server
+                std::cerr << "Error: accept() failed (" << std::strerror(error) << ")\n";
+                if (fatal) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+
+            // Bound how long a silent client can hold a worker.
+#ifdef _WIN32
+            DWORD timeout = 5000;
+#else
+            timeval timeout{5, 0};
+#endif
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+            pool.submit([&engine, client]() { handleConnection(engine, client); });
+        }
+        // The pool's destructor finishes in-flight requests.
+    }
+
+    closeSocket(listener);
+#ifdef _WIN32
+    WSACleanup();
+#else
+    if (!options.unix_socket.empty()) {
+        unlink(options.unix_socket.c_str());
+    }
+#endif
+    std::cout << "Server stopped." << std::endl;
+    return 0;
+}
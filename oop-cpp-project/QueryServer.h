@@ -0,0 +1,53 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include "QueryEngine.h"
+
+#include <string>
+
+/**
+ * @brief Where and how the resident query server listens.
+ */
+struct ServerOptions {
+    int port = 0;               // Listen on 127.0.0.1:<port> when > 0.
+    std::string unix_socket;    // Or listen on this Unix socket path (POSIX only); an existing non-socket file is refused.
+    unsigned workers = 0;       // Connection-handling threads; 0 uses all hardware threads.
+};
+
+/**
+ * @brief Answers one HTTP request against the engine.
+ *
+ * Routes:
+ *   GET  /health                 "ok"
+ *   GET  /query?q=<query>[&q=...] runs each q parameter (URL-encoded)
+ *   POST /query                  runs each line of the body
+ *
+ * Queries use the QueryEngine syntax without "> file" redirects. The
+ * response is 200 if every query succeeded and 400 otherwise. Failed queries
+ * appear in the body as "Error: ..." lines.
+ *
+ * @param engine The shared engine.
+ * @param method The HTTP method.
+ * @param target The request target, e.g. "/query?q=candles+AT+year".
+ * @param body The request body.
+ * @param body_out Receives the response body.
+ * @return The HTTP status code.
+ */
+int handleQueryRequest(QueryEngine& engine, const std::string& method, const std::string& target,
+                       const std::string& body, std::string& body_out);
+
+/**
+ * @brief Serves HTTP/1.0 query requests until SIGINT or SIGTERM.
+ *
+ * The loaded table and the engine's caches form a read-mostly snapshot
+ * shared by every connection. Accepted connections are handed to a thread
+ * pool, so slow clients do not block each other. Only loopback and Unix
+ * socket listeners are offered; there is no authentication.
+ *
+ * @param engine The shared engine.
+ * @param options The listener and pool settings.
+ * @return 0 after a clean shutdown, 1 if the listener could not be set up.
+ */
+int serveQueries(QueryEngine& engine, const ServerOptions& options);
+
+#endif // QUERY_SERVER_H
@@ -0,0 +1,188 @@
+#include "RangeQueryIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/**
+ * Index of the highest set bit, i.e. floor(log2(n)) for n > 0.
+ */
+size_t floorLog2(size_t n) {
+    size_t result = 0;
+    while (n >>= 1) {
+        ++result;
+    }
+    return result;
+}
+
+} // namespace
+
+/**
+ * Sorts out-of-order input into owned copies, then builds the valid-reading
+ * links, the valid-count prefix and the block sparse tables.
+ *
+ * @param timestamps Row timestamps, in any order.
+ * @param values The column; NaN marks a missing reading.
+ */
+RangeQueryIndex::RangeQueryIndex(const std::vector<int64_t>& timestamps, const std::vector<double>& values)
+    : timestamps_(&timestamps), values_(&values) {
+    if (!std::is_sorted(timestamps.begin(), timestamps.end())) {
+        std::vector<size_t> order(timestamps.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&timestamps](size_t a, size_t b) {
+            return timestamps[a] < timestamps[b];
+        });
+        sorted_timestamps_.reserve(order.size());
+        sorted_values_.reserve(order.size());
+        for (size_t row : order) {
+            sorted_timestamps_.push_back(timestamps[row]);
+            sorted_values_.push_back(values[row]);
+        }
+        timestamps_ = &sorted_timestamps_;
+        values_ = &sorted_values_;
+    }
+
+    const std::vector<double>& column = *values_;
+    const size_t n = column.size();
+    const uint32_t none = static_cast<uint32_t>(n);
+
+    next_valid_.resize(n);
+    prev_valid_plus1_.resize(n);
+    valid_prefix_.resize(n + 1);
+
+    valid_prefix_[0] = 0;
+    uint32_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        bool valid = !std::isnan(column[i]);
+        if (valid) {
+            prev = static_cast<uint32_t>(i + 1);
+        }
+        prev_valid_plus1_[i] = prev;
+        valid_prefix_[i + 1] = valid_prefix_[i] + (valid ? 1 : 0);
+    }
+
+    uint32_t next = none;
+    for (size_t i = n; i-- > 0;) {
+        if (!std::isnan(column[i])) {
+            next = static_cast<uint32_t>(i);
+        }
+        next_valid_[i] = next;
+    }
+
+    // Level 0: per-block extremes. Empty blocks hold +inf/-inf so they never win.
+    const size_t blocks = (n + kBlockSize - 1) >> kBlockShift;
+    block_min_.emplace_back(blocks, std::numeric_limits<double>::infinity());
+    block_max_.emplace_back(blocks, -std::numeric_limits<double>::infinity());
+    for (size_t b = 0; b < blocks; ++b) {
+        scan(b << kBlockShift, std::min(n, (b + 1) << kBlockShift), block_min_[0][b], block_max_[0][b]);
+    }
+
+    // Level k covers 2^k blocks starting at each position.
+    for (size_t k = 1; (size_t(1) << k) <= blocks; ++k) {
+        const size_t half = size_t(1) << (k - 1);
+        const size_t width = blocks - (size_t(1) << k) + 1;
+        std::vector<double> mins(width);
+        std::vector<double> maxs(width);
+        for (size_t b = 0; b < width; ++b) {
+            mins[b] = std::min(block_min_[k - 1][b], block_min_[k - 1][b + half]);
+            maxs[b] = std::max(block_max_[k - 1][b], block_max_[k - 1][b + half]);
+        }
+        block_min_.push_back(std::move(mins));
+        block_max_.push_back(std::move(maxs));
+    }
+}
+
+/**
+ * Builds the index for a country's temperature column.
+ *
+ * @param table The loaded weather data.
+ * @param country_prefix The country prefix, e.g. "DE".
+ */
+RangeQueryIndex::RangeQueryIndex(const WeatherTable& table, const std::string& country_prefix)
+    : RangeQueryIndex(table.timestamps, table.temperatureColumn(country_prefix)) {}
+
+/**
+ * Folds rows [first, last) into low/high. NaN fails both comparisons and is skipped.
+ */
+void RangeQueryIndex::scan(size_t first, size_t last, double& low, double& high) const {
+    const std::vector<double>& values = *values_;
+    for (size_t i = first; i < last; ++i) {
+        double value = values[i];
+        if (value < low) low = value;
+        if (value > high) high = value;
+    }
+}
+
+/**
+ * Maps the time window to a row range with two binary searches.
+ *
+ * @param start_time The first timestamp to include (epoch seconds).
+ * @param end_time The last timestamp to include (epoch seconds).
+ * @return The summary; empty if no valid reading falls in the window.
+ */
+RangeSummary RangeQueryIndex::query(int64_t start_time, int64_t end_time) const {
+    if (start_time > end_time) {
+        return RangeSummary();
+    }
+    auto first = std::lower_bound(timestamps_->begin(), timestamps_->end(), start_time);
+    auto last = std::upper_bound(first, timestamps_->end(), end_time);
+    return queryRows(static_cast<size_t>(first - timestamps_->begin()),
+                     static_cast<size_t>(last - timestamps_->begin()));
+}
+
+/**
+ * Answers a row range: open/close via the valid-reading links, low/high via
+ * the partial blocks at either end and the sparse table in between.
+ *
+ * @param first_row The first row to include.
+ * @param last_row One past the last row to include.
+ * @return The summary; empty if the range has no valid reading.
+ */
+RangeSummary RangeQueryIndex::queryRows(size_t first_row, size_t last_row) const {
+    RangeSummary summary;
+    last_row = std::min(last_row, size());
+    if (first_row >= last_row) {
+        return summary;
+    }
+
+    summary.count = valid_prefix_[last_row] - valid_prefix_[first_row];
+    if (summary.count == 0) {
+        return summary;
+    }
+
+    // Trim the range to its first and last valid rows.
+    size_t open_row = next_valid_[first_row];
+    size_t close_row = prev_valid_plus1_[last_row - 1] - 1;
+    summary.open = (*values_)[open_row];
+    summary.close = (*values_)[close_row];
+    summary.open_time = (*timestamps_)[open_row];
+    summary.close_time = (*timestamps_)[close_row];
+
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+    size_t first_block = open_row >> kBlockShift;
+    size_t last_block = close_row >> kBlockShift;
+
+    if (first_block == last_block) {
+        scan(open_row, close_row + 1, low, high);
+    } else {
+        scan(open_row, (first_block + 1) << kBlockShift, low, high);
+        scan(last_block << kBlockShift, close_row + 1, low, high);
+
+        if (first_block + 1 < last_block) {
+            size_t from = first_block + 1;
+            size_t span = last_block - from;
+            size_t k = floorLog2(span);
+            size_t other = last_block - (size_t(1) << k);
+            low = std::min({low, block_min_[k][from], block_min_[k][other]});
+            high = std::max({high, block_max_[k][from], block_max_[k][other]});
+        }
+    }
+
+    summary.low = low;
+    summary.high = high;
+    return summary;
+}
@@ -0,0 +1,93 @@
+#ifndef RANGE_QUERY_INDEX_H
+#define RANGE_QUERY_INDEX_H
+
+#include "WeatherTable.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Open/high/low/close of the readings inside one time window.
+ */
+struct RangeSummary {
+    size_t count = 0;        // Valid readings in the window; 0 means the rest is unset.
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    int64_t open_time = 0;   // Timestamp of the first valid reading.
+    int64_t close_time = 0;  // Timestamp of the last valid reading.
+
+    bool empty() const { return count == 0; }
+};
+
+/**
+ * @brief Range min/max index over one hourly column, for ad-hoc time windows.
+ *
+ * The column is split into blocks of 64 readings. Each block's min and max go
+ * into a sparse table, so the whole blocks of a window are answered with two
+ * lookups and only the partial blocks at either end are scanned. Next/previous
+ * valid-reading links give open and close in O(1) even across long runs of
+ * missing data. A window query costs two binary searches on the timestamps
+ * plus at most two 64-element scans.
+ *
+ * Memory is about 12 bytes per reading plus a few bytes per block. The
+ * timestamps and column must outlive the index. Timestamps that are not in
+ * ascending order are sorted into a copy of both arrays first (another 16
+ * bytes per reading), so open and close always follow time.
+ */
+class RangeQueryIndex {
+public:
+    /**
+     * @brief Builds the index in O(n), or O(n log n) if the timestamps need sorting.
+     *
+     * @param timestamps Row timestamps, in any order.
+     * @param values The column; NaN marks a missing reading.
+     */
+    RangeQueryIndex(const std::vector<int64_t>& timestamps, const std::vector<double>& values);
+
+    /**
+     * @brief Builds the index for a country's temperature column.
+     *
+     * @throws std::runtime_error if the country is unknown.
+     */
+    RangeQueryIndex(const WeatherTable& table, const std::string& country_prefix);
+
+    // The index may point into its own sorted copies, so it is never copied.
+    RangeQueryIndex(const RangeQueryIndex&) = delete;
+    RangeQueryIndex& operator=(const RangeQueryIndex&) = delete;
+
+    /**
+     * @brief Summarises the readings with timestamps in [start_time, end_time].
+     */
+    RangeSummary query(int64_t start_time, int64_t end_time) const;
+
+    /**
+     * @brief Summarises the readings in the row range [first_row, last_row).
+     *
+     * Rows are counted in timestamp order, which is the input's order when it
+     * was already sorted.
+     */
+    RangeSummary queryRows(size_t first_row, size_t last_row) const;
+
+    size_t size() const { return values_->size(); }
+
+private:
+    static constexpr size_t kBlockShift = 6;
+    static constexpr size_t kBlockSize = size_t(1) << kBlockShift;
+
+    void scan(size_t first, size_t last, double& low, double& high) const;
+
+    const std::vector<int64_t>* timestamps_;  // The input, or sorted_timestamps_.
+    const std::vector<double>* values_;       // The input, or sorted_values_.
+    std::vector<int64_t> sorted_timestamps_;  // Empty unless the input was out of order.
+    std::vector<double> sorted_values_;
+    std::vector<uint32_t> next_valid_;       // First valid row at or after i (size() if none).
+    std::vector<uint32_t> prev_valid_plus1_; // Last valid row at or before i, plus one (0 if none).
+    std::vector<uint32_t> valid_prefix_;     // Valid readings in rows [0, i).
+    std::vector<std::vector<double>> block_min_;  // block_min_[k][b]: min over blocks [b, b + 2^k).
+    std::vector<std::vector<double>> block_max_;
+};
+
+#endif // RANGE_QUERY_INDEX_H
@@ -0,0 +1,231 @@
+#include "Regression.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// --- PolynomialFit ---
+
+double PolynomialFit::evaluate(double x) const {
+    double t = (x - x_center) / x_scale;
+    double result = 0.0;
+    for (size_t k = coefficients.size(); k-- > 0;) {
+        result = result * t + coefficients[k];
+    }
+    return result;
+}
+
+/**
+ * Householder QR with column pivoting on the scaled Vandermonde matrix.
+ *
+ * @param x The x-coordinates.
+ * @param y The y-coordinates.
+ * @param degree The polynomial degree.
+ * @return The fit.
+ */
+PolynomialFit fitPolynomial(const std::vector<double>& x, const std::vector<double>& y, int degree) {
+    PolynomialFit fit;
+    fit.degree = std::max(degree, 0);
+    const size_t n = std::min(x.size(), y.size());
+    const size_t m = static_cast<size_t>(fit.degree) + 1;
+    fit.samples = n;
+    fit.coefficients.assign(m, 0.0);
+    if (n == 0) {
+        return fit;
+    }
+
+    // Centre and scale x onto [-1, 1].
+    double min_x = *std::min_element(x.begin(), x.begin() + n);
+    double max_x = *std::max_element(x.begin(), x.begin() + n);
+    fit.x_center = 0.5 * (min_x + max_x);
+    fit.x_scale = max_x > min_x ? 0.5 * (max_x - min_x) : 1.0;
+
+    // Column-major Vandermonde matrix A[i + j*n] = t_i^j, and a copy of y.
+    std::vector<double> a(n * m);
+    std::vector<double> b(y.begin(), y.begin() + n);
+    for (size_t i = 0; i < n; ++i) {
+        double t = (x[i] - fit.x_center) / fit.x_scale;
+        double power = 1.0;
+        for (size_t j = 0; j < m; ++j) {
+            a[i + j * n] = power;
+            power *= t;
+        }
+    }
+
+    std::vector<size_t> permutation(m);
+    for (size_t j = 0; j < m; ++j) {
+        permutation[j] = j;
+    }
+
+    auto column = [&a, n](size_t j) { return a.data() + j * n; };
+    auto tailNorm = [n](const double* col, size_t from) {
+        double sum = 0.0;
+        for (size_t i = from; i < n; ++i) {
+            sum += col[i] * col[i];
+        }
+        return std::sqrt(sum);
+    };
+
+    const size_t steps = std::min(n, m);
+    double first_diagonal = 0.0;
+    size_t rank = 0;
+    for (size_t k = 0; k < steps; ++k) {
+        // Pivot: bring the column with the largest remaining norm to position k.
+        size_t best = k;
+        double best_norm = tailNorm(column(k), k);
+        for (size_t j = k + 1; j < m; ++j) {
+            double norm = tailNorm(column(j), k);
+            if (norm > best_norm) {
+                best = j;
+                best_norm = norm;
+            }
+        }
+        if (best != k) {
+            std::swap_ranges(column(k), column(k) + n, column(best));
+            std::swap(permutation[k], permutation[best]);
+        }
+
+        if (k == 0) {
+            first_diagonal = best_norm;
+        }
+        if (best_norm <= 1e-12 * first_diagonal || best_norm == 0.0) {
+            break; // The remaining columns are numerically dependent
+        }
+
+        // Householder reflector v = x - alpha*e1, applied as I - 2vv^T/(v^T v).
+        double* col = column(k);
+        double alpha = col[k] > 0 ? -best_norm : best_norm;
+        col[k] -= alpha;
+        double v_norm2 = 0.0;
+        for (size_t i = k; i < n; ++i) {
+            v_norm2 += col[i] * col[i];
+        }
+
+        auto reflect = [&](double* target) {
+            double dot = 0.0;
+            for (size_t i = k; i < n; ++i) {
+                dot += col[i] * target[i];
+            }
+            double factor = 2.0 * dot / v_norm2;
+            for (size_t i = k; i < n; ++i) {
+                target[i] -= factor * col[i];
+            }
+        };
+        for (size_t j = k + 1; j < m; ++j) {
+            reflect(column(j));
+        }
+        reflect(b.data());
+
+        col[k] = alpha; // R's diagonal; the reflector below it is no longer needed
+        rank = k + 1;
+    }
+    fit.rank = rank;
+
+    // Back-substitute R z = Q^T b for the leading `rank` unknowns; the rest stay 0.
+    std::vector<double> z(m, 0.0);
+    for (size_t k = rank; k-- > 0;) {
+        double sum = b[k];
+        for (size_t j = k + 1; j < rank; ++j) {
+            sum -= column(j)[k] * z[j];
+        }
+        z[k] = sum / column(k)[k];
+    }
+    for (size_t k = 0; k < m; ++k) {
+        fit.coefficients[permutation[k]] = z[k];
+    }
+
+    double residual = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double error = y[i] - fit.evaluate(x[i]);
+        residual += error * error;
+    }
+    fit.rms_error = std::sqrt(residual / static_cast<double>(n));
+    return fit;
+}
+
+// --- Batch forecasting ---
+
+/**
+ * Computes yearly candles per distinct country, then fits every job as a
+ * ThreadPool task. Each task writes only its own result.
+ *
+ * @param table The loaded weather data.
+ * @param jobs The forecasts to run.
+ * @param threads Worker threads; 0 uses all hardware threads.
+ * @return One result per job, in job order.
+ */
+std::vector<RegressionResult> runRegressionBatch(const WeatherTable& table,
+                                                 const std::vector<RegressionJob>& jobs,
+                                                 unsigned threads) {
+    size_t workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> countries;
+    for (const auto& job : jobs) {
+        if (table.findColumn(job.country_prefix + "_temperature") != -1) {
+            countries.push_back(job.country_prefix);
+        }
+    }
+    std::sort(countries.begin(), countries.end());
+    countries.erase(std::unique(countries.begin(), countries.end()), countries.end());
+
+    std::map<std::string, std::vector<Candlestick>> yearly;
+    if (!countries.empty()) {
+        yearly = computeAllCandlestickData(table, TimeFrame::Year, countries);
+    }
+
+    std::vector<RegressionResult> results(jobs.size());
+    auto run = [&](size_t i) {
+        RegressionResult& result = results[i];
+        result.job = jobs[i];
+
+        auto series = yearly.find(result.job.country_prefix);
+        if (series == yearly.end()) {
+            result.error = "Temperature column not found for " + result.job.country_prefix;
+            return;
+        }
+
+        std::vector<double> x;
+        for (const auto& candle : series->second) {
+            int year = std::stoi(candle.date);
+            if (year >= result.job.start_year && year <= result.job.end_year) {
+                result.years.push_back(year);
+                result.values.push_back((candle.high + candle.low) / 2);
+                x.push_back(year);
+            }
+        }
+        if (result.years.empty()) {
+            result.error = "No data available for the selected country and date range.";
+            return;
+        }
+
+        result.fit = fitPolynomial(x, result.values, result.job.degree);
+        for (int h = 1; h <= result.job.horizon; ++h) {
+            int year = result.years.back() + h;
+            result.predict_years.push_back(year);
+            result.predictions.push_back(result.fit.evaluate(year));
+        }
+    };
+
+    if (jobs.empty()) {
+        return results;
+    }
+    {
+        // The pool's destructor waits for every queued job; pool tasks must not throw
+        ThreadPool pool(static_cast<unsigned>(std::min(workers, jobs.size())));
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            pool.submit([&run, &results, i]() {
+                try {
+                    run(i);
+                } catch (const std::exception& e) {
+                    results[i].error = e.what();
+                }
+            });
+        }
+    }
+    return results;
+}
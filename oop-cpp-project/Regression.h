@@ -0,0 +1,90 @@
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include "WeatherTable.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A least-squares polynomial fitted in centred and scaled coordinates.
+ *
+ * The polynomial is stored in t = (x - x_center) / x_scale, which maps the
+ * fitted x range onto [-1, 1]. With x around 2000, raw powers like x^4 reach
+ * 1.6e13 and swamp the small coefficients; in t every power stays within
+ * [-1, 1].
+ */
+struct PolynomialFit {
+    int degree = 0;
+    double x_center = 0.0;
+    double x_scale = 1.0;
+    std::vector<double> coefficients;  // coefficients[k] multiplies t^k.
+    size_t rank = 0;                   // Numerical rank; coefficients past it are 0.
+    size_t samples = 0;
+    double rms_error = 0.0;            // Root-mean-square residual over the samples.
+
+    /**
+     * @brief Evaluates the polynomial at x using Horner's rule.
+     */
+    double evaluate(double x) const;
+};
+
+/**
+ * @brief Fits a least-squares polynomial.
+ *
+ * Builds the Vandermonde matrix in scaled coordinates and solves it with
+ * Householder QR and column pivoting. Rank-deficient inputs, such as fewer
+ * samples than coefficients or repeated x, get a basic solution instead of
+ * dividing by zero.
+ *
+ * @param x The x-coordinates.
+ * @param y The y-coordinates, same length as x.
+ * @param degree The polynomial degree (>= 0).
+ * @return The fit; rank 0 if there are no samples.
+ */
+PolynomialFit fitPolynomial(const std::vector<double>& x, const std::vector<double>& y, int degree);
+
+// --- Batch forecasting ---
+
+/**
+ * @brief One forecast to run: a country, a year window and a degree.
+ */
+struct RegressionJob {
+    std::string country_prefix;
+    int start_year = 0;
+    int end_year = 0;
+    int degree = 2;
+    int horizon = 3;  // Number of years after the last observed year to predict.
+};
+
+/**
+ * @brief The outcome of one RegressionJob.
+ */
+struct RegressionResult {
+    RegressionJob job;
+    std::vector<int> years;               // Observed years in the window.
+    std::vector<double> values;           // Yearly averages, (high + low) / 2.
+    PolynomialFit fit;
+    std::vector<int> predict_years;
+    std::vector<double> predictions;
+    std::string error;                    // Non-empty if the job could not run.
+};
+
+/**
+ * @brief Runs many forecasts in parallel against one table.
+ *
+ * Yearly candles are computed once per distinct country and shared by every
+ * job for that country. Failures such as an unknown country are reported in
+ * the job's result rather than aborting the batch.
+ *
+ * @param table The loaded weather data.
+ * @param jobs The forecasts to run.
+ * @param threads Worker threads; 0 uses all hardware threads.
+ * @return One result per job, in job order.
+ */
+std::vector<RegressionResult> runRegressionBatch(const WeatherTable& table,
+                                                 const std::vector<RegressionJob>& jobs,
+                                                 unsigned threads = 0);
+
+#endif // REGRESSION_H
@@ -0,0 +1,118 @@
+#include "TemperatureIntervalIndex.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+/**
+ * Sorts the candles by low, then builds the tree top-down.
+ *
+ * @param candlesticks The series to index.
+ */
+TemperatureIntervalIndex::TemperatureIntervalIndex(const std::vector<Candlestick>& candlesticks)
+    : candlesticks_(&candlesticks) {
+    std::vector<uint32_t> by_low(candlesticks.size());
+    std::iota(by_low.begin(), by_low.end(), 0);
+    std::stable_sort(by_low.begin(), by_low.end(), [&candlesticks](uint32_t a, uint32_t b) {
+        return candlesticks[a].low < candlesticks[b].low;
+    });
+
+    nodes_.reserve(candlesticks.size());
+    root_ = build(by_low, 0, by_low.size());
+}
+
+/**
+ * Builds the subtree for by_low[begin, end): the candle with the largest high
+ * becomes the node, and the rest, still sorted by low, split at the median.
+ * Each level costs O(n), and there are log2(n) levels, so recursion is shallow.
+ *
+ * @param by_low Candle positions sorted by low; the range is reordered in place.
+ * @param begin First position of the subtree.
+ * @param end One past the last position of the subtree.
+ * @return The subtree's node, or -1 if the range is empty.
+ */
+int32_t TemperatureIntervalIndex::build(std::vector<uint32_t>& by_low, size_t begin, size_t end) {
+    if (begin >= end) {
+        return -1;
+    }
+
+    const std::vector<Candlestick>& candles = *candlesticks_;
+    auto top = std::max_element(by_low.begin() + begin, by_low.begin() + end, [&candles](uint32_t a, uint32_t b) {
+        return candles[a].high < candles[b].high;
+    });
+
+    // Move the node's candle to the front; the rest stays sorted by low
+    std::rotate(by_low.begin() + begin, top, top + 1);
+    const uint32_t candle = by_low[begin];
+    const size_t rest = begin + 1;
+    const size_t mid = rest + (end - rest) / 2;
+
+    int32_t node = static_cast<int32_t>(nodes_.size());
+    nodes_.push_back({candles[candle].low, candles[candle].high,
+                      mid < end ? candles[by_low[mid]].low : std::numeric_limits<double>::infinity(), candle, -1, -1});
+
+    int32_t left = build(by_low, rest, mid);
+    int32_t right = build(by_low, mid, end);
+    nodes_[node].left = left;
+    nodes_[node].right = right;
+    return node;
+}
+
+/**
+ * Walks the tree with an explicit stack.
+ *
+ * @param min_temp The bottom of the band.
+ * @param max_temp The top of the band.
+ * @return Indices into the series, in series order.
+ */
+std::vector<size_t> TemperatureIntervalIndex::overlapping(double min_temp, double max_temp) const {
+    std::vector<size_t> result;
+    if (min_temp > max_temp) {
+        return result;
+    }
+
+    std::vector<int32_t> stack;
+    if (root_ != -1) {
+        stack.push_back(root_);
+    }
+    while (!stack.empty()) {
+        const Node& node = nodes_[static_cast<size_t>(stack.back())];
+        stack.pop_back();
+        if (node.high < min_temp) {
+            continue; // Nothing in this subtree reaches the band
+        }
+
+        if (node.low <= max_temp) {
+            result.push_back(node.series_index);
+        }
+        if (node.left != -1) {
+            stack.push_back(node.left);
+        }
+        if (node.right != -1 && node.right_low <= max_temp) {
+            stack.push_back(node.right);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * Returns the overlapping candles truncated to the band.
+ *
+ * @param min_temp The bottom of the band.
+ * @param max_temp The top of the band.
+ * @return The truncated candles, in series order.
+ */
+std::vector<Candlestick> TemperatureIntervalIndex::query(double min_temp, double max_temp) const {
+    std::vector<Candlestick> result;
+    std::vector<size_t> matches = overlapping(min_temp, max_temp);
+    result.reserve(matches.size());
+
+    for (size_t index : matches) {
+        result.push_back((*candlesticks_)[index]);
+        result.back().truncate(min_temp, max_temp);
+    }
+    return result;
+}
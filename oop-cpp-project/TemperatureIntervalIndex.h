@@ -0,0 +1,72 @@
+#ifndef TEMPERATURE_INTERVAL_INDEX_H
+#define TEMPERATURE_INTERVAL_INDEX_H
+
+#include "Candlestick.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Static priority search tree over the [low, high] ranges of a candlestick series.
+ *
+ * A candle overlaps the band [min_temp, max_temp] exactly when
+ * low <= max_temp and high >= min_temp, a three-sided query on the points
+ * (low, high). Each node holds the candle with the largest high among its
+ * subtree (a max-heap on high) and splits the remaining candles at their
+ * median low (a search tree on low). A query stops at any node whose high is
+ * below the band, since nothing beneath it can reach the band, and enters a
+ * right subtree only if its smallest low is within the band. Apart from the
+ * O(log n) nodes along the max_temp boundary, every visited node is reported,
+ * so finding the k overlapping candles takes O(log n + k). Returning them in
+ * series order adds an O(k log k) sort.
+ *
+ * The series must outlive the index.
+ */
+class TemperatureIntervalIndex {
+public:
+    /**
+     * @brief Builds the index in O(n log n).
+     *
+     * @param candlesticks The series to index.
+     */
+    explicit TemperatureIntervalIndex(const std::vector<Candlestick>& candlesticks);
+
+    /**
+     * @brief Finds candles whose [low, high] overlaps [min_temp, max_temp].
+     *
+     * @return Indices into the series, in series order.
+     */
+    std::vector<size_t> overlapping(double min_temp, double max_temp) const;
+
+    /**
+     * @brief Returns the overlapping candles truncated to the band.
+     *
+     * Produces exactly what filterByTemperatureRange returns for the same series.
+     */
+    std::vector<Candlestick> query(double min_temp, double max_temp) const;
+
+    size_t size() const { return nodes_.size(); }
+
+    /**
+     * @brief The series the index was built over.
+     */
+    const std::vector<Candlestick>& series() const { return *candlesticks_; }
+
+private:
+    struct Node {
+        double low;
+        double high;           // The largest high in this subtree.
+        double right_low;      // The smallest low in the right subtree.
+        uint32_t series_index; // Position of this node's candle in the series.
+        int32_t left;          // Child node, or -1.
+        int32_t right;         // Child node, or -1.
+    };
+
+    int32_t build(std::vector<uint32_t>& by_low, size_t begin, size_t end);
+
+    const std::vector<Candlestick>* candlesticks_;
+    std::vector<Node> nodes_;
+    int32_t root_ = -1;
+};
+
+#endif // TEMPERATURE_INTERVAL_INDEX_H
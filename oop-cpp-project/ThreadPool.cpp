@@ -0,0 +1,58 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(unsigned threads) {
+    unsigned count = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * Lets the workers drain the queue, then joins them.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * Queues a task and wakes one worker.
+ *
+ * @param task The work to run.
+ */
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    available_.notify_one();
+}
+
+/**
+ * Runs tasks until the pool is stopping and the queue is empty.
+ */
+void ThreadPool::workerLoop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return; // Stopping and nothing left to do
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
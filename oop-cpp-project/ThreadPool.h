@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads draining a FIFO task queue.
+ *
+ * Tasks must not throw. The destructor finishes every queued task before
+ * joining the workers.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param threads Number of workers; 0 uses all hardware threads.
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for the next free worker.
+     */
+    void submit(Task task);
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::queue<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    bool stopping_ = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,187 @@
+#include "TimeFrame.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+/**
+ * Buckets rows in order, starting a new entry whenever the id changes. If the
+ * ids did not come out ascending, the runs are remapped onto the sorted,
+ * distinct ids.
+ *
+ * @param timestamps Epoch seconds, one per row.
+ * @param time_frame The bucket size.
+ * @param row_bucket Receives each row's index into the returned ids.
+ * @return The distinct bucket ids, ascending.
+ */
+std::vector<int64_t> assignTimeBuckets(const std::vector<int64_t>& timestamps, const TimeFrameSpec& time_frame,
+                                       std::vector<uint32_t>& row_bucket) {
+    std::vector<int64_t> ids;
+    row_bucket.resize(timestamps.size());
+    bool ascending = true;
+
+    withTimeBucketer(time_frame, [&](auto bucketer) {
+        for (size_t i = 0; i < timestamps.size(); ++i) {
+            int64_t id = bucketer.bucketId(timestamps[i], time_frame.interval_hours);
+            if (ids.empty() || id != ids.back()) {
+                ascending = ascending && (ids.empty() || id > ids.back());
+                ids.push_back(id);
+            }
+            row_bucket[i] = static_cast<uint32_t>(ids.size() - 1);
+        }
+    });
+    if (ascending) {
+        return ids;
+    }
+
+    std::vector<int64_t> sorted = ids;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    for (auto& bucket : row_bucket) {
+        bucket = static_cast<uint32_t>(std::lower_bound(sorted.begin(), sorted.end(), ids[bucket]) - sorted.begin());
+    }
+    return sorted;
+}
+
+/**
+ * Maps epoch seconds to a bucket id with a run-time choice of bucketer.
+ *
+ * @param epoch_seconds Seconds since the Unix epoch.
+ * @param spec The time frame.
+ * @return The bucket id.
+ */
+int64_t timeBucketId(int64_t epoch_seconds, const TimeFrameSpec& spec) {
+    return withTimeBucketer(spec, [&](auto bucketer) {
+        return bucketer.bucketId(epoch_seconds, spec.interval_hours);
+    });
+}
+
+/**
+ * Returns the first second covered by a bucket.
+ *
+ * @param bucket_id A bucket id for spec.
+ * @param spec The time frame.
+ * @return Seconds since the Unix epoch.
+ */
+int64_t timeBucketStart(int64_t bucket_id, const TimeFrameSpec& spec) {
+    switch (spec.frame) {
+        case TimeFrame::Hour:
+            return bucket_id * 3600;
+        case TimeFrame::Day:
+            return bucket_id * 86400;
+        case TimeFrame::Week:
+            return (bucket_id * 7 - 3) * 86400;
+        case TimeFrame::Month: {
+            int64_t year = floorDiv(bucket_id, 12);
+            return daysFromCivil(static_cast<int>(year), static_cast<int>(bucket_id - year * 12) + 1, 1) * 86400;
+        }
+        case TimeFrame::Quarter: {
+            int64_t year = floorDiv(bucket_id, 4);
+            return daysFromCivil(static_cast<int>(year), static_cast<int>(bucket_id - year * 4) * 3 + 1, 1) * 86400;
+        }
+        case TimeFrame::HourInterval:
+            return bucket_id * 3600LL * spec.interval_hours;
+        case TimeFrame::Year:
+        case TimeFrame::Decade:
+        default:
+            return daysFromCivil(static_cast<int>(bucket_id), 1, 1) * 86400;
+    }
+}
+
+/**
+ * Formats a bucket id as a candle label.
+ *
+ * @param bucket_id A bucket id for spec.
+ * @param spec The time frame.
+ * @return The label.
+ */
+std::string timeBucketLabel(int64_t bucket_id, const TimeFrameSpec& spec) {
+    char buffer[32];
+    switch (spec.frame) {
+        case TimeFrame::Hour:
+        case TimeFrame::HourInterval:
+            return formatTimestamp(timeBucketStart(bucket_id, spec)).substr(0, 13);
+        case TimeFrame::Day:
+            return formatTimestamp(timeBucketStart(bucket_id, spec)).substr(0, 10);
+        case TimeFrame::Week: {
+            // The ISO week-numbering year is the year that contains the week's Thursday
+            int64_t thursday = bucket_id * 7;
+            int iso_year = civilFromDays(thursday).year;
+            int week = static_cast<int>((thursday - daysFromCivil(iso_year, 1, 1)) / 7 + 1);
+            std::snprintf(buffer, sizeof(buffer), "%04d-W%02d", iso_year, week);
+            break;
+        }
+        case TimeFrame::Month: {
+            int64_t year = floorDiv(bucket_id, 12);
+            std::snprintf(buffer, sizeof(buffer), "%04d-%02d", static_cast<int>(year),
+                          static_cast<int>(bucket_id - year * 12) + 1);
+            break;
+        }
+        case TimeFrame::Quarter: {
+            int64_t year = floorDiv(bucket_id, 4);
+            std::snprintf(buffer, sizeof(buffer), "%04d-Q%d", static_cast<int>(year),
+                          static_cast<int>(bucket_id - year * 4) + 1);
+            break;
+        }
+        case TimeFrame::Decade:
+            std::snprintf(buffer, sizeof(buffer), "%04ds", static_cast<int>(bucket_id));
+            break;
+        case TimeFrame::Year:
+        default:
+            std::snprintf(buffer, sizeof(buffer), "%04d", static_cast<int>(bucket_id));
+            break;
+    }
+    return buffer;
+}
+
+/**
+ * Parses a time frame name such as "month" or "6h".
+ *
+ * @param name The time frame name.
+ * @return The parsed time frame.
+ */
+TimeFrameSpec parseTimeFrame(const std::string& name) {
+    if (name == "hour") return TimeFrame::Hour;
+    if (name == "day") return TimeFrame::Day;
+    if (name == "week") return TimeFrame::Week;
+    if (name == "month") return TimeFrame::Month;
+    if (name == "quarter") return TimeFrame::Quarter;
+    if (name == "year") return TimeFrame::Year;
+    if (name == "decade") return TimeFrame::Decade;
+
+    if (name.size() >= 2 && name.back() == 'h') {
+        int hours = 0;
+        for (size_t i = 0; i + 1 < name.size(); ++i) {
+            if (name[i] < '0' || name[i] > '9' || hours > 100000) {
+                hours = 0;
+                break;
+            }
+            hours = hours * 10 + (name[i] - '0');
+        }
+        if (hours > 0) {
+            return TimeFrameSpec(TimeFrame::HourInterval, hours);
+        }
+    }
+
+    throw std::runtime_error("Unknown time frame: " + name);
+}
+
+/**
+ * Returns the name of a time frame.
+ *
+ * @param spec The time frame.
+ * @return A name accepted by parseTimeFrame.
+ */
+std::string timeFrameName(const TimeFrameSpec& spec) {
+    switch (spec.frame) {
+        case TimeFrame::Hour: return "hour";
+        case TimeFrame::Day: return "day";
+        case TimeFrame::Week: return "week";
+        case TimeFrame::Month: return "month";
+        case TimeFrame::Quarter: return "quarter";
+        case TimeFrame::Decade: return "decade";
+        case TimeFrame::HourInterval: return std::to_string(spec.interval_hours) + "h";
+        case TimeFrame::Year:
+        default: return "year";
+    }
+}
@@ -0,0 +1,192 @@
+#ifndef TIME_FRAME_H
+#define TIME_FRAME_H
+
+#include "DateTime.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Time frames candlesticks can be grouped by.
+ */
+enum class TimeFrame {
+    Hour,
+    Day,
+    Week,          // ISO-8601 week, starting on Monday.
+    Month,
+    Quarter,
+    Year,
+    Decade,
+    HourInterval   // Fixed blocks of N hours, aligned to the Unix epoch.
+};
+
+/**
+ * @brief A time frame plus its interval length for TimeFrame::HourInterval.
+ *
+ * Implicitly constructible from a TimeFrame, so TimeFrame::Year can be passed
+ * wherever a TimeFrameSpec is expected.
+ */
+struct TimeFrameSpec {
+    TimeFrame frame;
+    int interval_hours;  // Only used by TimeFrame::HourInterval.
+
+    TimeFrameSpec(TimeFrame f = TimeFrame::Year, int hours = 1) : frame(f), interval_hours(hours) {}
+
+    bool operator==(const TimeFrameSpec& other) const {
+        return frame == other.frame && (frame != TimeFrame::HourInterval || interval_hours == other.interval_hours);
+    }
+    bool operator!=(const TimeFrameSpec& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Maps epoch seconds to an integer bucket id for one time frame.
+ *
+ * Each specialisation is a handful of integer operations, so loops that are
+ * instantiated per time frame (see withTimeBucketer) carry no per-row string
+ * work or branching on the frame. Bucket ids increase with time.
+ */
+template <TimeFrame F>
+struct TimeBucketer;
+
+template <>
+struct TimeBucketer<TimeFrame::Hour> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        return floorDiv(epoch_seconds, 3600);
+    }
+};
+
+template <>
+struct TimeBucketer<TimeFrame::Day> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        return floorDiv(epoch_seconds, 86400);
+    }
+};
+
+template <>
+struct TimeBucketer<TimeFrame::Week> {
+    // 1970-01-01 was a Thursday; shifting by 3 days makes weeks start on Monday.
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        return floorDiv(floorDiv(epoch_seconds, 86400) + 3, 7);
+    }
+};
+
+template <>
+struct TimeBucketer<TimeFrame::Month> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        CivilTime civil = civilFromEpoch(epoch_seconds);
+        return civil.year * 12LL + (civil.month - 1);
+    }
+};
+
+template <>
+struct TimeBucketer<TimeFrame::Quarter> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        CivilTime civil = civilFromEpoch(epoch_seconds);
+        return civil.year * 4LL + (civil.month - 1) / 3;
+    }
+};
+
+template <>
+struct TimeBucketer<TimeFrame::Year> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        return civilFromEpoch(epoch_seconds).year;
+    }
+};
+
+/**
+ * @brief Returns the decade bucket id of a year: the decade's first year.
+ */
+constexpr int64_t decadeOfYear(int64_t year) { return floorDiv(year, 10) * 10; }
+
+template <>
+struct TimeBucketer<TimeFrame::Decade> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int) {
+        return decadeOfYear(civilFromEpoch(epoch_seconds).year);
+    }
+};
+
+template <>
+struct TimeBucketer<TimeFrame::HourInterval> {
+    static constexpr int64_t bucketId(int64_t epoch_seconds, int interval_hours) {
+        return floorDiv(epoch_seconds, 3600LL * interval_hours);
+    }
+};
+
+/**
+ * @brief Calls fn with the TimeBucketer for spec.frame.
+ *
+ * The switch runs once; fn is instantiated per time frame, so any loop inside
+ * it is compiled with the bucketing inlined.
+ *
+ * @param spec The time frame.
+ * @param fn A generic callable taking a TimeBucketer<F> by value.
+ * @return Whatever fn returns.
+ */
+template <typename Fn>
+decltype(auto) withTimeBucketer(const TimeFrameSpec& spec, Fn&& fn) {
+    switch (spec.frame) {
+        case TimeFrame::Hour: return fn(TimeBucketer<TimeFrame::Hour>());
+        case TimeFrame::Day: return fn(TimeBucketer<TimeFrame::Day>());
+        case TimeFrame::Week: return fn(TimeBucketer<TimeFrame::Week>());
+        case TimeFrame::Month: return fn(TimeBucketer<TimeFrame::Month>());
+        case TimeFrame::Quarter: return fn(TimeBucketer<TimeFrame::Quarter>());
+        case TimeFrame::Decade: return fn(TimeBucketer<TimeFrame::Decade>());
+        case TimeFrame::HourInterval: return fn(TimeBucketer<TimeFrame::HourInterval>());
+        case TimeFrame::Year:
+        default: return fn(TimeBucketer<TimeFrame::Year>());
+    }
+}
+
+/**
+ * @brief Assigns every timestamp to a bucket in one pass.
+ *
+ * Time-ordered input is a single scan; out-of-order input is also handled.
+ *
+ * @param timestamps Epoch seconds, one per row.
+ * @param time_frame The bucket size.
+ * @param row_bucket Receives, for each row, an index into the returned ids.
+ * @return The distinct bucket ids, ascending.
+ */
+std::vector<int64_t> assignTimeBuckets(const std::vector<int64_t>& timestamps, const TimeFrameSpec& time_frame,
+                                       std::vector<uint32_t>& row_bucket);
+
+/**
+ * @brief Maps epoch seconds to a bucket id, choosing the bucketer at run time.
+ *
+ * Prefer withTimeBucketer inside per-row loops.
+ */
+int64_t timeBucketId(int64_t epoch_seconds, const TimeFrameSpec& spec);
+
+/**
+ * @brief Returns the first second covered by a bucket.
+ */
+int64_t timeBucketStart(int64_t bucket_id, const TimeFrameSpec& spec);
+
+/**
+ * @brief Formats a bucket id as a candle label.
+ *
+ * Labels sort in date order: "2003-06-15T13" (hour and N-hour), "2003-06-15"
+ * (day), "2003-W24" (week), "2003-06" (month), "2003-Q2" (quarter), "2003"
+ * (year) and "2000s" (decade).
+ */
+std::string timeBucketLabel(int64_t bucket_id, const TimeFrameSpec& spec);
+
+/**
+ * @brief Parses a time frame name.
+ *
+ * Accepts "hour", "day", "week", "month", "quarter", "year", "decade", and
+ * "Nh" (e.g., "6h") for N-hour intervals.
+ *
+ * @param name The time frame name.
+ * @return The parsed time frame.
+ * @throws std::runtime_error for unknown names.
+ */
+TimeFrameSpec parseTimeFrame(const std::string& name);
+
+/**
+ * @brief Returns the name parseTimeFrame accepts for a time frame.
+ */
+std::string timeFrameName(const TimeFrameSpec& spec);
+
+#endif // TIME_FRAME_H
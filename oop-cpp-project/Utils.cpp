@@ -1,595 +1,812 @@
-#include "Utils.h"
-#include "Candlestick.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
-#include <iomanip>
-#include <vector>
-#include <string>
-#include <map>
-#include <algorithm>
-#include <limits>
-#include <cmath>
-
-// --- General Utility Functions ---
-
-/**
- * Reads a CSV file and returns its content as a 2D vector of strings.
- * 
- * @param filename The name of the CSV file.
- * @return A 2D vector where each inner vector represents a row of the file.
- */
-std::vector<std::vector<std::string>> readCSV(const std::string &filename) {
-    std::vector<std::vector<std::string>> data;
-    std::ifstream file(filename);
-
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return data;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        std::vector<std::string> row;
-        std::stringstream ss(line);
-        std::string cell;
-
-        while (std::getline(ss, cell, ',')) {
-            row.push_back(cell);
-        }
-
-        if (!row.empty()) {
-            data.push_back(row);
-        }
-    }
-
-    file.close();
-    return data;
-}
-
-// --- Task 1: Candlestick Data Computation ---
-
-/**
- * Computes candlestick data for a specific country and time frame.
- * 
- * @param data The dataset as a 2D vector of strings.
- * @param country_prefix The prefix for the country (e.g., "AT" for Austria).
- * @param time_frame The time frame for aggregation ("year", "month", or "day").
- * @return A vector of computed candlestick objects.
- */
-std::vector<Candlestick> computeCandlestickData(
-    const std::vector<std::vector<std::string>> &data,
-    const std::string &country_prefix,
-    const std::string &time_frame) {
-    std::map<std::string, std::vector<double>> grouped_data;
-    int temp_column = -1;
-
-    // Identify the temperature column
-    for (size_t i = 0; i < data[0].size(); ++i) {
-        if (data[0][i] == country_prefix + "_temperature") {
-            temp_column = i;
-            break;
-        }
-    }
-
-    if (temp_column == -1) {
-        throw std::runtime_error("Temperature column not found for " + country_prefix);
-    }
-
-    // Group data based on the specified time frame
-    for (size_t i = 1; i < data.size(); ++i) {
-        std::string timestamp = data[i][0];
-        std::string time_key;
-
-        if (time_frame == "year") {
-            time_key = timestamp.substr(0, 4);
-        } else if (time_frame == "month") {
-            time_key = timestamp.substr(0, 7);
-        } else if (time_frame == "day") {
-            time_key = timestamp.substr(0, 10);
-        }
-
-        try {
-            double temp = std::stod(data[i][temp_column]);
-            grouped_data[time_key].push_back(temp);
-        } catch (const std::exception &) {
-            std::cerr << "Invalid temperature data: Skipping row " << i << std::endl;
-        }
-    }
-
-    // Compute candlestick metrics for each group
-    std::vector<Candlestick> candlesticks;
-    for (const auto &[key, temps] : grouped_data) {
-        double open = temps.front();
-        double close = temps.back();
-        double high = *std::max_element(temps.begin(), temps.end());
-        double low = *std::min_element(temps.begin(), temps.end());
-        candlesticks.push_back({key, open, high, low, close});
-    }
-
-    return candlesticks;
-}
-
-// --- Task 2: Plotting Functions ---
-
-/**
- * Groups candlesticks by decade.
- * 
- * @param candlesticks A vector of candlestick data to be grouped.
- * @return A vector of grouped candlesticks, where each inner vector contains data for a single decade.
- */
-std::vector<std::vector<Candlestick>> groupByDecade(const std::vector<Candlestick>& candlesticks) {
-    std::vector<std::vector<Candlestick>> grouped;
-    int current_decade = -1;
-    std::vector<Candlestick> current_group;
-
-    for (const auto& candle : candlesticks) {
-        int year = std::stoi(candle.date); // Convert date to integer year
-        int decade = (year / 10) * 10;
-
-        if (decade != current_decade) {
-            if (!current_group.empty()) {
-                grouped.push_back(current_group);
-            }
-            current_group.clear();
-            current_decade = decade;
-        }
-
-        current_group.push_back(candle);
-    }
-
-    if (!current_group.empty()) {
-        grouped.push_back(current_group);
-    }
-
-    return grouped;
-}
-
-/**
- * Plots a single group of candlesticks with a text-based visualization.
- * 
- * @param candlesticks A vector of candlestick data to plot.
- * @param plot_height The height of the plot (number of rows in the output).
- */
-void plotCandlestickGroup(const std::vector<Candlestick>& candlesticks, int plot_height) {
-    if (candlesticks.empty()) {
-        std::cout << "No candlestick data to plot.\n";
-        return;
-    }
-
-    double global_high = -1e9, global_low = 1e9;
-
-    // Find the global high and low for the filtered candlesticks
-    for (const auto& candle : candlesticks) {
-        global_high = std::max(global_high, candle.high);
-        global_low = std::min(global_low, candle.low);
-    }
-
-    double range = global_high - global_low;
-    if (range == 0) range = 1; // Prevent division by zero
-
-    // Adjust plot height dynamically based on range
-    int adjusted_plot_height = std::min(plot_height, static_cast<int>(range * 2));
-    adjusted_plot_height = std::max(adjusted_plot_height, 10); // Ensure a minimum plot height
-
-    // Print y-axis labels and candlesticks
-    for (int i = adjusted_plot_height; i >= 0; --i) {
-        double temp = global_low + (i * range / adjusted_plot_height);
-        std::cout << std::setw(5) << std::fixed << std::setprecision(1) << temp << " | ";
-
-        for (const auto& candle : candlesticks) {
-            double open_pos = (candle.open - global_low) / range * adjusted_plot_height;
-            double close_pos = (candle.close - global_low) / range * adjusted_plot_height;
-            double high_pos = (candle.high - global_low) / range * adjusted_plot_height;
-            double low_pos = (candle.low - global_low) / range * adjusted_plot_height;
-
-            if (i == static_cast<int>(high_pos)) {
-                std::cout << "*      "; // High
-            } else if (i == static_cast<int>(low_pos)) {
-                std::cout << "*      "; // Low
-            } else if (i == static_cast<int>(open_pos)) {
-                std::cout << "O      "; // Open
-            } else if (i == static_cast<int>(close_pos)) {
-                std::cout << "C      "; // Close
-            } else if (i < static_cast<int>(high_pos) && i > static_cast<int>(low_pos)) {
-                std::cout << "|      "; // Vertical stalk
-            } else {
-                std::cout << "       "; // Empty space
-            }
-        }
-        std::cout << "\n";
-    }
-
-    // Print year labels below the plot
-    std::cout << "     "; // Space for the y-axis labels
-    for (size_t i = 0; i < candlesticks.size(); ++i) {
-        std::cout << std::setw(7) << candlesticks[i].date;
-    }
-    std::cout << "\n";
-}
-
-/**
- * Plots grouped candlesticks by decade with a text-based visualization.
- * 
- * @param candlesticks A vector of candlestick data to group and plot.
- * @param plot_height The height of the plot for each group (number of rows in the output).
- */
-void plotGroupedCandlesticks(const std::vector<Candlestick>& candlesticks, int plot_height) {
-    auto grouped = groupByDecade(candlesticks);
-
-    for (const auto& group : grouped) {
-        if (!group.empty()) {
-            int decade = std::stoi(group[0].date) / 10 * 10;
-            std::cout << "\nCandlestick Data for " << decade << "s:\n";
-            plotCandlestickGroup(group, plot_height);
-            std::cout << "-----------------------------------\n";
-        }
-    }
-}
-
-// --- Task 3: Filtering Functions ---
-
-/**
- * Filters candlesticks by a date range.
- * 
- * @param candlesticks The list of candlestick data.
- * @param start_date The start date of the range (inclusive).
- * @param end_date The end date of the range (inclusive).
- * @return A vector of candlesticks within the specified date range.
- */
-std::vector<Candlestick> filterByDateRange(
-    const std::vector<Candlestick>& candlesticks,
-    const std::string& start_date,
-    const std::string& end_date) {
-    std::vector<Candlestick> filtered;
-    for (const auto& candle : candlesticks) {
-        if (candle.date >= start_date && candle.date <= end_date) {
-            filtered.push_back(candle);
-        }
-    }
-    return filtered;
-}
-
-/**
- * Filters candlesticks by a temperature range.
- * 
- * @param candlesticks The list of candlestick data.
- * @param min_temp The minimum temperature.
- * @param max_temp The maximum temperature.
- * @return A vector of candlesticks within the specified temperature range.
- */
-std::vector<Candlestick> filterByTemperatureRange(
-    const std::vector<Candlestick>& candlesticks,
-    double min_temp,
-    double max_temp) {
-    std::vector<Candlestick> filtered;
-
-    for (const auto& candle : candlesticks) {
-        if (candle.high < min_temp || candle.low > max_temp) {
-            continue; 
-        }
-
-        // Create a truncated candlestick within the range
-        Candlestick truncated = candle;
-        truncated.high = std::min(candle.high, max_temp);
-        truncated.low = std::max(candle.low, min_temp);
-        truncated.open = std::clamp(candle.open, truncated.low, truncated.high);
-        truncated.close = std::clamp(candle.close, truncated.low, truncated.high);
-        filtered.push_back(truncated);
-    }
-
-    return filtered;
-}
-
-/**
- * Filters candlesticks by country and time frame.
- * 
- * @param data The dataset as a 2D vector of strings.
- * @param country_prefix The country prefix (e.g., "AT" for Austria).
- * @param time_frame The time frame (e.g., "year", "month", or "day").
- * @return A vector of candlesticks for the specified country and time frame.
- */
-std::vector<Candlestick> filterByCountry(
-    const std::vector<std::vector<std::string>>& data,
-    const std::string& country_prefix,
-    const std::string& time_frame) {
-    try {
-        return computeCandlestickData(data, country_prefix, time_frame);
-    } catch (const std::exception& e) {
-        std::cerr << "Error during country filtering: " << e.what() << std::endl;
-        return {};
-    }
-}
-
-/**
- * Provides a mapping of country prefixes to country names.
- * 
- * @return A map where keys are country prefixes (e.g., "AT") and values are country names.
- */
-std::map<std::string, std::string> getCountryMapping() {
-    return {
-        {"AT", "Austria"}, {"BE", "Belgium"}, {"BG", "Bulgaria"}, {"CH", "Switzerland"},
-        {"CZ", "Czech Republic"}, {"DE", "Germany"}, {"DK", "Denmark"}, {"EE", "Estonia"},
-        {"ES", "Spain"}, {"FI", "Finland"}, {"FR", "France"}, {"GB", "United Kingdom"},
-        {"GR", "Greece"}, {"HR", "Croatia"}, {"HU", "Hungary"}, {"IE", "Ireland"},
-        {"IT", "Italy"}, {"LT", "Lithuania"}, {"LU", "Luxembourg"}, {"LV", "Latvia"},
-        {"NL", "Netherlands"}, {"NO", "Norway"}, {"PL", "Poland"}, {"PT", "Portugal"},
-        {"RO", "Romania"}, {"SE", "Sweden"}, {"SI", "Slovenia"}, {"SK", "Slovakia"}
-    };
-}
-
-/**
- * Displays the available countries for filtering.
- * 
- * @param data The dataset as a 2D vector of strings.
- */
-void displayAvailableCountries(const std::vector<std::vector<std::string>>& data) {
-    auto country_map = getCountryMapping();
-
-    std::cout << "\n--- Available Country Prefixes and Names ---\n";
-    for (const auto& header : data[0]) {
-        if (header.find("_temperature") != std::string::npos) {
-            std::string country_prefix = header.substr(0, header.find("_"));
-            std::string country_name = country_map.count(country_prefix) > 0
-                ? country_map[country_prefix]
-                : "Unknown";
-            std::cout << "- " << country_prefix << " (" << country_name << ")\n";
-        }
-    }
-    std::cout << std::endl;
-}
-
-/**
- * Displays the global temperature range available.
- * 
- * @param data The dataset as a 2D vector of strings.
- */
-void displayAvailableTemperatureRange(const std::vector<std::vector<std::string>>& data) {
-    double global_min_temp = std::numeric_limits<double>::max();
-    double global_max_temp = std::numeric_limits<double>::lowest();
-
-    for (size_t i = 0; i < data[0].size(); ++i) {
-        if (data[0][i].find("_temperature") != std::string::npos) {
-            for (size_t j = 1; j < data.size(); ++j) {
-                try {
-                    double temp = std::stod(data[j][i]);
-                    global_min_temp = std::min(global_min_temp, temp);
-                    global_max_temp = std::max(global_max_temp, temp);
-                } catch (const std::exception&) {
-                    continue;
-                }
-            }
-        }
-    }
-
-    if (global_min_temp != std::numeric_limits<double>::max() && 
-        global_max_temp != std::numeric_limits<double>::lowest()) {
-        std::cout << "\n--- Global Temperature Range ---\n";
-        std::cout << "Minimum: " << global_min_temp << " degree Celsius\n";
-        std::cout << "Maximum: " << global_max_temp << " degree Celsius\n";
-    } else {
-        std::cout << "No valid temperature data found.\n";
-    }
-}
-
-/**
- * Displays the available date range.
- * 
- * @param data The dataset as a 2D vector of strings.
- */
-void displayAvailableDateRange(const std::vector<std::vector<std::string>>& data) {
-    if (data.size() < 2) {
-        std::cout << "No date range available (data might be empty).\n";
-        return;
-    }
-
-    std::string start_date = data[1][0];                   
-    std::string end_date = data[data.size() - 1][0];       
-
-    std::cout << "\n--- Available Date Range ---\n";
-    std::cout << "Start: " << start_date.substr(0, 10) << "\n";
-    std::cout << "End: " << end_date.substr(0, 10) << "\n\n";
-}
-
-// Task 4: Polynomial Regression
-
-/**
- * Performs polynomial regression to fit a polynomial to the given data points
- * and predicts values for specified x-coordinates.
- * 
- * @param x A vector of x-coordinates (independent variable, e.g., years).
- * @param y A vector of y-coordinates (dependent variable, e.g., temperatures).
- * @param degree The degree of the polynomial to fit.
- * @param predict_x A vector of x-coordinates for which predictions are needed.
- * @return A vector of predicted y-coordinates corresponding to predict_x.
- */
-std::vector<double> polynomialRegression(const std::vector<int>& x, 
-                                         const std::vector<double>& y, 
-                                         int degree, 
-                                         const std::vector<int>& predict_x) {
-    int n = x.size(); // Number of data points
-    int m = degree + 1; // Degree of the polynomial + 1 (number of coefficients)
-
-    // Create matrix for least squares
-    std::vector<std::vector<double>> X(m, std::vector<double>(m, 0));
-    std::vector<double> Y(m, 0);
-
-    // Populate the elements of X and Y
-    for (int i = 0; i < n; ++i) {
-        double xi = 1.0; // Start with x^0
-        for (int j = 0; j < m; ++j) {
-            for (int k = 0; k < m; ++k) {
-                X[j][k] += xi * std::pow(x[i], k); // Compute sum of powers of x
-            }
-            Y[j] += xi * y[i]; // Compute sum of x*y
-            xi *= x[i]; // Increment the power of x
-        }
-    }
-
-    // Solve the linear system X * B = Y to find coefficients B
-    std::vector<double> B(m, 0); // Coefficients of the polynomial
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < m; ++j) {
-            if (i != j) { 
-                double ratio = X[j][i] / X[i][i]; // Ratio for elimination
-                for (int k = 0; k < m; ++k) {
-                    X[j][k] -= ratio * X[i][k]; // Eliminate element in the row
-                }
-                Y[j] -= ratio * Y[i]; // Adjust corresponding element in Y
-            }
-        }
-    }
-    for (int i = 0; i < m; ++i) {
-        B[i] = Y[i] / X[i][i]; // Calculate coefficients
-    }
-
-    // Use coefficients B to calculate predictions
-    std::vector<double> predictions;
-    for (const auto& px : predict_x) {
-        double pred = 0.0; // Initialize prediction
-        double xi = 1.0; // Start with x^0
-        for (int j = 0; j < m; ++j) {
-            pred += B[j] * xi; // Add term to prediction
-            xi *= px; // Increment power of x
-        }
-        predictions.push_back(pred); // Store prediction
-    }
-
-    return predictions; // Return all predictions
-}
-
-/**
- * Predicts and displays temperature trends for a selected country based on historical data.
- * 
- * @param data A 2D vector of strings representing the dataset.
- * @param country_prefix The prefix for the country.
- * @param startYear The start year of the analysis period.
- * @param endYear The end year of the analysis period.
- */
-void predictAndDisplayTemperatures(const std::vector<std::vector<std::string>>& data, 
-                                   const std::string& country_prefix, 
-                                   int startYear, int endYear) {
-    // Compute candlestick data for the selected country
-    auto candlesticks = computeCandlestickData(data, country_prefix, "year");
-
-    // Extract years and average temperatures
-    std::vector<int> years; // To store years
-    std::vector<double> avg_temps; // To store average temperatures
-
-    for (const auto& candle : candlesticks) {
-        int year = std::stoi(candle.date); // Convert date string to year
-        if (year >= startYear && year <= endYear) { // Filter by year range
-            years.push_back(year); // Add year to list
-            avg_temps.push_back((candle.high + candle.low) / 2); // Compute average temperature
-        }
-    }
-
-    // Check if data is available
-    if (years.empty() || avg_temps.empty()) {
-        std::cout << "No data available for the selected country and date range.\n";
-        return;
-    }
-
-    // Define prediction years
-    std::vector<int> predict_years = {years.back() + 1, years.back() + 2, years.back() + 3};
-
-    // Perform polynomial regression to predict temperatures
-    auto predictions = polynomialRegression(years, avg_temps, 2, predict_years); // Degree 2 polynomial
-
-    // Display historical data
-    std::cout << "\n--- Historical Temperature Data ---\n";
-    for (size_t i = 0; i < years.size(); ++i) {
-        std::cout << "Year: " << years[i] << ", Avg Temp: " << avg_temps[i] << " degree Celsius\n";
-    }
-
-    // Display predictions
-    std::cout << "\n--- Prediction Summary ---\n";
-    std::cout << "Country: " << country_prefix << "\n";
-    std::cout << "Date Range: " << startYear << " to " << endYear << "\n";
-    std::cout << "Predicted Temperatures for Upcoming Years:\n";
-    for (size_t i = 0; i < predict_years.size(); ++i) {
-        std::cout << "Year: " << predict_years[i] << ", Predicted Temp: " << predictions[i] << " degree Celsius\n";
-    }
-
-    // Visualization: Text-Based Plot
-    // Calculate the minimum and maximum temperatures
-    double min_temp = *std::min_element(avg_temps.begin(), avg_temps.end());
-    double max_temp = *std::max_element(avg_temps.begin(), avg_temps.end());
-    min_temp = std::min(min_temp, *std::min_element(predictions.begin(), predictions.end()));
-    max_temp = std::max(max_temp, *std::max_element(predictions.begin(), predictions.end()));
-
-    // Calculate the range and plot height
-    double range = max_temp - min_temp;
-    int plot_height = 8; // Height of the text-based plot
-    if (range == 0) range = 1; // Prevent division by zero
-
-    std::cout << "\n--- Text-Based Visualization ---\n";
-
-    // Determine the year interval based on the time period
-    int time_period = years.back() - years.front() + 1;
-    int year_interval = (time_period > 20) ? 5 : (time_period > 10 ? 2 : 1);
-
-    // Configure plot alignment
-    int column_width = 2; // Width for year labels
-    int axis_spacing = 1; // Space between Y-axis and plot
-
-    // Print the Y-axis and data points
-for (int i = plot_height; i >= 0; --i) {
-    double temp_level = min_temp + (i * range / plot_height); // Temperature for this level
-    std::cout << std::fixed << std::setprecision(1) << std::setw(6) << temp_level << " |";
-    std::cout << std::string(axis_spacing, ' '); // Add space after Y-axis
-
-    // Plot historical data for labelled years only
-    for (size_t j = 0; j < years.size(); ++j) {
-        if (years[j] % year_interval == 0) { 
-            double pos = (avg_temps[j] - min_temp) / range * plot_height;
-            if (static_cast<int>(std::round(pos)) == i) {
-                std::cout << std::setw(column_width - 1) << "O"; // Mark historical data point
-            } else {
-                std::cout << std::string(column_width, ' '); // Maintain spacing
-            }
-        } else {
-            std::cout << std::string(column_width, ' '); // Maintain spacing for unlabelled years
-        }
-    }
-
-    // Plot predicted data for labelled years only
-    for (size_t j = 0; j < predict_years.size(); ++j) {
-        if (predict_years[j] % year_interval == 0) { 
-            double pos = (predictions[j] - min_temp) / range * plot_height;
-            if (static_cast<int>(std::round(pos)) == i) {
-                std::cout << std::setw(column_width - 1) << "*"; // Mark predicted data point
-            } else {
-                std::cout << std::string(column_width, ' '); // Maintain spacing
-            }
-        } else {
-            std::cout << std::string(column_width, ' '); // Maintain spacing for unlabelled years
-        }
-    }
-    std::cout << "\n";
-}
-
-    // Print X-axis labels
-    std::cout << "       "; // Align with Y-axis
-    std::cout << std::string(axis_spacing, ' '); // Space after Y-axis
-
-    // Print historical year labels
-    for (size_t j = 0; j < years.size(); ++j) {
-        if (years[j] % year_interval == 0) {
-            std::cout << " '" << std::setw(2) << std::setfill('0') << (years[j] % 100);
-        } else {
-            std::cout << std::string(column_width, ' ');
-        }
-    }
-
-    // Print predicted year labels
-    for (size_t j = 0; j < predict_years.size(); ++j) {
-        if (predict_years[j] % year_interval == 0) {
-            std::cout << " '" << std::setw(2) << std::setfill('0') << (predict_years[j] % 100);
-        } else {
-            std::cout << std::string(column_width, ' ');
-        }
-    }
-    std::cout << "\n";
-}
-
+#include "Utils.h"
+#include "Candlestick.h"
+#include "CandlestickAggregator.h"
+#include "CandleView.h"
+#include "CandlestickRenderer.h"
+#include "CsvReader.h"
+#include "DateTime.h"
+#include "Decimation.h"
+#include "Instrumentation.h"
+#include "Regression.h"
+#include "TimeFrame.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <memory_resource>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// --- General Utility Functions ---
+
+/**
+ * Reads a CSV file and returns its content as a 2D vector of strings.
+ *
+ * Compatibility wrapper around CsvReader: the file is memory-mapped and split
+ * without intermediate streams, then each cell is copied once into the result.
+ * New code should use CsvReader directly and work on the string views.
+ *
+ * @param filename The name of the CSV file.
+ * @return A 2D vector where each inner vector represents a row of the file.
+ */
+std::vector<std::vector<std::string>> readCSV(const std::string &filename) {
+    ScopedTimer timer("load.read_csv");
+    std::vector<std::vector<std::string>> data;
+    CsvReader reader(filename);
+
+    if (!reader.isOpen()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return data;
+    }
+
+    std::string_view text = reader.contents();
+    data.reserve(static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+
+    reader.forEachRow([&data](size_t, const std::vector<std::string_view>& cells) {
+        std::vector<std::string> row;
+        row.reserve(cells.size());
+        for (const auto& cell : cells) {
+            row.emplace_back(cell);
+        }
+        data.push_back(std::move(row));
+    });
+
+    Instrumentation::add(Counter::RowsRead, data.empty() ? 0 : data.size() - 1);
+    return data;
+}
+
+// --- Task 1: Candlestick Data Computation ---
+
+/**
+ * Computes candlestick data for a specific country and time frame.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ * @param country_prefix The prefix for the country (e.g., "AT" for Austria).
+ * @param time_frame The time frame for aggregation (see parseTimeFrame, e.g. "year", "month", "week" or "6h").
+ * @return A vector of computed candlestick objects.
+ */
+std::vector<Candlestick> computeCandlestickData(
+    const std::vector<std::vector<std::string>> &data,
+    const std::string &country_prefix,
+    const std::string &time_frame) {
+    ScopedTimer timer("candles.legacy");
+    const TimeFrameSpec spec = parseTimeFrame(time_frame);
+
+    // Bucket nodes come from a stack arena, spilling to the heap only for long
+    // hourly series, and are all released together on return
+    std::byte arena_buffer[16 * 1024];
+    std::pmr::monotonic_buffer_resource arena(arena_buffer, sizeof(arena_buffer));
+    struct Bucket {
+        OhlcAccumulator ohlc;
+        int64_t first_time = 0;
+        int64_t last_time = 0;
+    };
+    std::pmr::map<int64_t, Bucket> grouped_data(&arena);
+    size_t parsed_cells = 0, invalid_cells = 0;
+    int temp_column = -1;
+
+    // Identify the temperature column
+    for (size_t i = 0; i < data[0].size(); ++i) {
+        if (data[0][i] == country_prefix + "_temperature") {
+            temp_column = i;
+            break;
+        }
+    }
+
+    if (temp_column == -1) {
+        throw std::runtime_error("Temperature column not found for " + country_prefix);
+    }
+
+    // Group data based on the specified time frame. Bad rows are only counted
+    // here and reported once below, so empty stretches cost no console writes.
+    size_t invalid_timestamps = 0;
+    for (size_t i = 1; i < data.size(); ++i) {
+        int64_t timestamp;
+        if (data[i].empty() || !parseTimestamp(data[i][0], timestamp)) {
+            ++invalid_timestamps;
+            continue;
+        }
+
+        double temp;
+        if (static_cast<size_t>(temp_column) < data[i].size() && parseDouble(data[i][temp_column], temp)) {
+            Bucket &bucket = grouped_data[timeBucketId(timestamp, spec)];
+            bucket.ohlc.addAt(temp, timestamp, bucket.first_time, bucket.last_time);
+            ++parsed_cells;
+        } else {
+            ++invalid_cells;
+        }
+    }
+
+    if (invalid_timestamps > 0) {
+        std::cerr << "Warning: Skipped " << invalid_timestamps << " rows with an invalid timestamp" << std::endl;
+    }
+    if (invalid_cells > 0) {
+        std::cerr << "Warning: Skipped " << invalid_cells << " rows with invalid temperature data for "
+                  << country_prefix << std::endl;
+    }
+    Instrumentation::add(Counter::CellsParsed, parsed_cells);
+    Instrumentation::add(Counter::InvalidCells, invalid_cells);
+    Instrumentation::add(Counter::BucketsCreated, grouped_data.size());
+    Instrumentation::add(Counter::BytesAllocated, grouped_data.size() * sizeof(Candlestick));
+
+    // Emit one candlestick per group; each group only kept its running OHLC
+    std::vector<Candlestick> candlesticks;
+    candlesticks.reserve(grouped_data.size());
+    for (const auto &[key, bucket] : grouped_data) {
+        candlesticks.push_back(bucket.ohlc.toCandlestick(timeBucketLabel(key, spec)));
+    }
+
+    return candlesticks;
+}
+
+/**
+ * Computes candlestick data for a country from a parsed table.
+ *
+ * @param table The parsed weather table.
+ * @param country_prefix The prefix for the country (e.g., "AT" for Austria).
+ * @param time_frame The time frame for aggregation.
+ * @return A vector of computed candlestick objects.
+ */
+std::vector<Candlestick> computeCandlestickData(
+    const WeatherTable &table,
+    const std::string &country_prefix,
+    const TimeFrameSpec &time_frame) {
+    auto all_candles = computeAllCandlestickData(table, time_frame, {country_prefix});
+    return std::move(all_candles[country_prefix]);
+}
+
+/**
+ * Computes candlestick data for a country from a parsed table.
+ *
+ * @param table The parsed weather table.
+ * @param country_prefix The prefix for the country (e.g., "AT" for Austria).
+ * @param time_frame The time frame name (see parseTimeFrame).
+ * @return A vector of computed candlestick objects.
+ */
+std::vector<Candlestick> computeCandlestickData(
+    const WeatherTable &table,
+    const std::string &country_prefix,
+    const std::string &time_frame) {
+    return computeCandlestickData(table, country_prefix, parseTimeFrame(time_frame));
+}
+
+/**
+ * Computes candlestick data for many countries in one pass over the table.
+ *
+ * The bucket of every row is computed once and shared by all columns. Each
+ * temperature column is then scanned contiguously, keeping only a running
+ * open/high/low/close per bucket. A bucket's open and close are its earliest
+ * and latest readings by timestamp, so rows out of time order give the same
+ * candles as sorted ones.
+ *
+ * @param table The parsed weather table.
+ * @param time_frame The time frame for aggregation.
+ * @param country_prefixes The countries to compute; empty means every country.
+ * @return A map from country prefix to its candlesticks, ordered by date.
+ */
+std::map<std::string, std::vector<Candlestick>> computeAllCandlestickData(
+    const WeatherTable &table,
+    const TimeFrameSpec &time_frame,
+    const std::vector<std::string> &country_prefixes) {
+    std::vector<std::string> countries = country_prefixes.empty() ? table.countryPrefixes() : country_prefixes;
+    std::vector<const std::vector<double> *> temp_columns;
+    std::vector<const ValidityBitmap *> temp_validity;
+    for (const auto &country : countries) {
+        temp_columns.push_back(&table.temperatureColumn(country));
+        temp_validity.push_back(&table.temperatureValidity(country));
+    }
+
+    // Assign every row to a bucket once, shared by every column
+    std::vector<uint32_t> row_bucket;
+    std::vector<int64_t> bucket_ids;
+    {
+        ScopedTimer timer("candles.group");
+        bucket_ids = assignTimeBuckets(table.timestamps, time_frame, row_bucket);
+    }
+
+    Instrumentation::add(Counter::BucketsCreated, bucket_ids.size());
+    Instrumentation::add(Counter::BytesAllocated, row_bucket.size() * sizeof(uint32_t) +
+                         bucket_ids.size() * (sizeof(OhlcAccumulator) + countries.size() * sizeof(Candlestick)));
+
+    // Aggregate each column with the shared row -> bucket assignment
+    ScopedTimer timer("candles.build");
+    std::map<std::string, std::vector<Candlestick>> result;
+    std::vector<OhlcAccumulator> buckets;
+
+    // Each bucket's label is formatted once and shared by every country
+    std::vector<std::string> labels(bucket_ids.size());
+    for (size_t b = 0; b < bucket_ids.size(); ++b) {
+        labels[b] = timeBucketLabel(bucket_ids[b], time_frame);
+    }
+
+    // Rows out of time order also track each bucket's first and last timestamp
+    const bool in_order = std::is_sorted(table.timestamps.begin(), table.timestamps.end());
+    std::vector<int64_t> first_time(in_order ? 0 : bucket_ids.size()), last_time(first_time.size());
+
+    for (size_t c = 0; c < countries.size(); ++c) {
+        const std::vector<double> &temps = *temp_columns[c];
+        buckets.assign(bucket_ids.size(), OhlcAccumulator());
+
+        if (in_order) {
+            temp_validity[c]->forEachValid(0, temps.size(), [&](size_t i) {
+                buckets[row_bucket[i]].add(temps[i]);
+            });
+        } else {
+            temp_validity[c]->forEachValid(0, temps.size(), [&](size_t i) {
+                const uint32_t b = row_bucket[i];
+                buckets[b].addAt(temps[i], table.timestamps[i], first_time[b], last_time[b]);
+            });
+        }
+
+        std::vector<Candlestick> &candlesticks = result[countries[c]];
+        candlesticks.reserve(bucket_ids.size());
+        for (size_t b = 0; b < bucket_ids.size(); ++b) {
+            if (!buckets[b].empty()) {
+                candlesticks.push_back(buckets[b].toCandlestick(labels[b]));
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Computes candlestick data for many countries in one pass over the table.
+ *
+ * @param table The parsed weather table.
+ * @param time_frame The time frame name (see parseTimeFrame).
+ * @param country_prefixes The countries to compute; empty means every country.
+ * @return A map from country prefix to its candlesticks, ordered by date.
+ */
+std::map<std::string, std::vector<Candlestick>> computeAllCandlestickData(
+    const WeatherTable &table,
+    const std::string &time_frame,
+    const std::vector<std::string> &country_prefixes) {
+    return computeAllCandlestickData(table, parseTimeFrame(time_frame), country_prefixes);
+}
+
+// --- Task 2: Plotting Functions ---
+
+/**
+ * Groups candlesticks by decade, with the same decade ids as the Decade time frame.
+ * 
+ * @param candlesticks A vector of candlestick data to be grouped.
+ * @return A vector of grouped candlesticks, where each inner vector contains data for a single decade.
+ */
+std::vector<std::vector<Candlestick>> groupByDecade(const std::vector<Candlestick>& candlesticks) {
+    std::vector<std::vector<Candlestick>> grouped;
+    int64_t current_decade = -1;
+    std::vector<Candlestick> current_group;
+
+    for (const auto& candle : candlesticks) {
+        int64_t decade = decadeOfYear(std::stoi(candle.date)); // Every label starts with the year
+
+        if (decade != current_decade) {
+            if (!current_group.empty()) {
+                grouped.push_back(std::move(current_group));
+            }
+            current_group.clear();
+            current_decade = decade;
+        }
+
+        current_group.push_back(candle);
+    }
+
+    if (!current_group.empty()) {
+        grouped.push_back(std::move(current_group));
+    }
+
+    return grouped;
+}
+
+/**
+ * Plots a single group of candlesticks with a text-based visualization.
+ * 
+ * @param candlesticks A vector of candlestick data to plot.
+ * @param plot_height The height of the plot (number of rows in the output).
+ * @param out The stream to write to.
+ * @param overlays Indicator lines aligned with the candlesticks.
+ */
+void plotCandlestickGroup(const std::vector<Candlestick>& candlesticks, int plot_height, std::ostream& out,
+                          const std::vector<PlotOverlay>& overlays = {}) {
+    std::string frame = CandlestickRenderer(plot_height).render(candlesticks, overlays);
+    out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+
+    // The per-cell plot left the stream in fixed, one-decimal mode; later output relies on it
+    if (!candlesticks.empty()) {
+        out << std::fixed << std::setprecision(1);
+    }
+}
+
+/**
+ * Plots grouped candlesticks by decade with a text-based visualization.
+ * 
+ * @param candlesticks A vector of candlestick data to group and plot.
+ * @param plot_height The height of the plot for each group (number of rows in the output).
+ * @param out The stream to write to.
+ * @param max_columns The output width; 0 uses the terminal width.
+ * @param overlays Indicator lines aligned with the candlesticks, split and decimated with them.
+ */
+void plotGroupedCandlesticks(const std::vector<Candlestick>& candlesticks, int plot_height, std::ostream& out,
+                             size_t max_columns, const std::vector<PlotOverlay>& overlays) {
+    // Each row is a 8-column axis plus 7 columns per candle; merge candles beyond that
+    ScopedTimer timer("plot");
+    size_t columns = max_columns > 0 ? max_columns : terminalColumns();
+    size_t max_candles = std::max<size_t>(1, columns > 8 ? (columns - 8) / 7 : 1);
+
+    auto grouped = groupByDecade(candlesticks);
+
+    size_t first = 0; // Index of the group's first candle, to slice the overlays
+    for (const auto& group : grouped) {
+        if (!group.empty()) {
+            int64_t decade = decadeOfYear(std::stoi(group[0].date));
+            out << "\nCandlestick Data for " << decade << "s:\n";
+
+            std::vector<PlotOverlay> group_overlays;
+            for (const auto& overlay : overlays) {
+                size_t begin = std::min(first, overlay.values.size());
+                size_t end = std::min(first + group.size(), overlay.values.size());
+                std::vector<double> slice(overlay.values.begin() + begin, overlay.values.begin() + end);
+                group_overlays.push_back({decimateSeries(slice, max_candles), overlay.glyph});
+            }
+            plotCandlestickGroup(decimateCandles(group, max_candles), plot_height, out, group_overlays);
+            out << "-----------------------------------\n";
+        }
+        first += group.size();
+    }
+}
+
+// --- Task 3: Filtering Functions ---
+
+/**
+ * Filters candlesticks by a date range.
+ * 
+ * @param candlesticks The list of candlestick data, sorted by date.
+ * @param start_date The start date of the range (inclusive).
+ * @param end_date The end date of the range (inclusive).
+ * @return A vector of candlesticks within the specified date range.
+ */
+std::vector<Candlestick> filterByDateRange(
+    const std::vector<Candlestick>& candlesticks,
+    const std::string& start_date,
+    const std::string& end_date) {
+    ScopedTimer timer("filter.date_range");
+    return CandleView(candlesticks).dateRange(start_date, end_date).materialize();
+}
+
+/**
+ * Filters candlesticks by a temperature range.
+ * 
+ * @param candlesticks The list of candlestick data.
+ * @param min_temp The minimum temperature.
+ * @param max_temp The maximum temperature.
+ * @return A vector of candlesticks within the specified temperature range.
+ */
+std::vector<Candlestick> filterByTemperatureRange(
+    const std::vector<Candlestick>& candlesticks,
+    double min_temp,
+    double max_temp) {
+    ScopedTimer timer("filter.temperature_range");
+    return CandleView(candlesticks).temperatureRange(min_temp, max_temp).materialize();
+}
+
+/**
+ * Filters candlesticks by a temperature range through an interval index.
+ * 
+ * @param index The interval index over the candlesticks.
+ * @param min_temp The minimum temperature.
+ * @param max_temp The maximum temperature.
+ * @return A vector of candlesticks within the specified temperature range.
+ */
+std::vector<Candlestick> filterByTemperatureRange(
+    const TemperatureIntervalIndex& index,
+    double min_temp,
+    double max_temp) {
+    ScopedTimer timer("filter.temperature_range");
+    return index.query(min_temp, max_temp);
+}
+
+/**
+ * Filters candlesticks by country and time frame.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame (e.g., "year", "month", or "day").
+ * @return A vector of candlesticks for the specified country and time frame.
+ */
+std::vector<Candlestick> filterByCountry(
+    const std::vector<std::vector<std::string>>& data,
+    const std::string& country_prefix,
+    const std::string& time_frame) {
+    try {
+        return computeCandlestickData(data, country_prefix, time_frame);
+    } catch (const std::exception& e) {
+        std::cerr << "Error during country filtering: " << e.what() << std::endl;
+        return {};
+    }
+}
+
+/**
+ * Filters candlesticks by country and time frame, reading them from the country's rollup.
+ *
+ * @param rollups Per-country rollups.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame (e.g., "year", "month", or "day").
+ * @return A vector of candlesticks for the specified country and time frame.
+ */
+std::vector<Candlestick> filterByCountry(
+    const std::map<std::string, CandleRollup>& rollups,
+    const std::string& country_prefix,
+    const std::string& time_frame) {
+    try {
+        return findCandleRollup(rollups, country_prefix).candles(parseTimeFrame(time_frame));
+    } catch (const std::exception& e) {
+        std::cerr << "Error during country filtering: " << e.what() << std::endl;
+        return {};
+    }
+}
+
+/**
+ * Provides a mapping of country prefixes to country names.
+ * 
+ * @return A map where keys are country prefixes (e.g., "AT") and values are country names.
+ */
+std::map<std::string, std::string> getCountryMapping() {
+    return {
+        {"AT", "Austria"}, {"BE", "Belgium"}, {"BG", "Bulgaria"}, {"CH", "Switzerland"},
+        {"CZ", "Czech Republic"}, {"DE", "Germany"}, {"DK", "Denmark"}, {"EE", "Estonia"},
+        {"ES", "Spain"}, {"FI", "Finland"}, {"FR", "France"}, {"GB", "United Kingdom"},
+        {"GR", "Greece"}, {"HR", "Croatia"}, {"HU", "Hungary"}, {"IE", "Ireland"},
+        {"IT", "Italy"}, {"LT", "Lithuania"}, {"LU", "Luxembourg"}, {"LV", "Latvia"},
+        {"NL", "Netherlands"}, {"NO", "Norway"}, {"PL", "Poland"}, {"PT", "Portugal"},
+        {"RO", "Romania"}, {"SE", "Sweden"}, {"SI", "Slovenia"}, {"SK", "Slovakia"}
+    };
+}
+
+/**
+ * Displays the available countries for filtering.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ */
+void displayAvailableCountries(const std::vector<std::vector<std::string>>& data) {
+    auto country_map = getCountryMapping();
+
+    std::cout << "\n--- Available Country Prefixes and Names ---\n";
+    for (const auto& header : data[0]) {
+        if (header.find("_temperature") != std::string::npos) {
+            std::string country_prefix = header.substr(0, header.find("_"));
+            std::string country_name = country_map.count(country_prefix) > 0
+                ? country_map[country_prefix]
+                : "Unknown";
+            std::cout << "- " << country_prefix << " (" << country_name << ")\n";
+        }
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * Displays the available countries in a parsed table.
+ *
+ * @param table The parsed weather table.
+ */
+void displayAvailableCountries(const WeatherTable& table) {
+    auto country_map = getCountryMapping();
+
+    std::cout << "\n--- Available Country Prefixes and Names ---\n";
+    for (const auto& country_prefix : table.countryPrefixes()) {
+        std::string country_name = country_map.count(country_prefix) > 0
+            ? country_map[country_prefix]
+            : "Unknown";
+        std::cout << "- " << country_prefix << " (" << country_name << ")\n";
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * Displays the global temperature range available.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ */
+void displayAvailableTemperatureRange(const std::vector<std::vector<std::string>>& data) {
+    double global_min_temp = std::numeric_limits<double>::max();
+    double global_max_temp = std::numeric_limits<double>::lowest();
+
+    for (size_t i = 0; i < data[0].size(); ++i) {
+        if (data[0][i].find("_temperature") != std::string::npos) {
+            for (size_t j = 1; j < data.size(); ++j) {
+                double temp;
+                if (i < data[j].size() && parseDouble(data[j][i], temp)) {
+                    global_min_temp = std::min(global_min_temp, temp);
+                    global_max_temp = std::max(global_max_temp, temp);
+                }
+            }
+        }
+    }
+
+    if (global_min_temp != std::numeric_limits<double>::max() && 
+        global_max_temp != std::numeric_limits<double>::lowest()) {
+        std::cout << "\n--- Global Temperature Range ---\n";
+        std::cout << "Minimum: " << global_min_temp << " degree Celsius\n";
+        std::cout << "Maximum: " << global_max_temp << " degree Celsius\n";
+    } else {
+        std::cout << "No valid temperature data found.\n";
+    }
+}
+
+/**
+ * Displays the global temperature range of a parsed table. Only the
+ * temperature columns are scanned, and missing readings are skipped using
+ * each column's validity bitmap.
+ *
+ * @param table The parsed weather table.
+ */
+void displayAvailableTemperatureRange(const WeatherTable& table) {
+    double global_min_temp = std::numeric_limits<double>::max();
+    double global_max_temp = std::numeric_limits<double>::lowest();
+
+    for (size_t c = 0; c < table.columns.size(); ++c) {
+        if (table.column_names[c].find("_temperature") == std::string::npos) {
+            continue;
+        }
+        const std::vector<double>& temps = table.columns[c];
+        table.validity[c].forEachValid(0, temps.size(), [&](size_t i) {
+            global_min_temp = std::min(global_min_temp, temps[i]);
+            global_max_temp = std::max(global_max_temp, temps[i]);
+        });
+    }
+
+    if (global_min_temp != std::numeric_limits<double>::max() &&
+        global_max_temp != std::numeric_limits<double>::lowest()) {
+        std::cout << "\n--- Global Temperature Range ---\n";
+        std::cout << "Minimum: " << global_min_temp << " degree Celsius\n";
+        std::cout << "Maximum: " << global_max_temp << " degree Celsius\n";
+    } else {
+        std::cout << "No valid temperature data found.\n";
+    }
+}
+
+/**
+ * Displays the available date range.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ */
+void displayAvailableDateRange(const std::vector<std::vector<std::string>>& data) {
+    if (data.size() < 2) {
+        std::cout << "No date range available (data might be empty).\n";
+        return;
+    }
+
+    std::string start_date = data[1][0];                   
+    std::string end_date = data[data.size() - 1][0];       
+
+    std::cout << "\n--- Available Date Range ---\n";
+    std::cout << "Start: " << start_date.substr(0, 10) << "\n";
+    std::cout << "End: " << end_date.substr(0, 10) << "\n\n";
+}
+
+/**
+ * Displays the available date range of a parsed table.
+ *
+ * @param table The parsed weather table.
+ */
+void displayAvailableDateRange(const WeatherTable& table) {
+    if (table.empty()) {
+        std::cout << "No date range available (data might be empty).\n";
+        return;
+    }
+
+    std::string start_date = formatTimestamp(table.timestamps.front());
+    std::string end_date = formatTimestamp(table.timestamps.back());
+
+    std::cout << "\n--- Available Date Range ---\n";
+    std::cout << "Start: " << start_date.substr(0, 10) << "\n";
+    std::cout << "End: " << end_date.substr(0, 10) << "\n\n";
+}
+
+// Task 4: Polynomial Regression
+
+/**
+ * Performs polynomial regression to fit a polynomial to the given data points
+ * and predicts values for specified x-coordinates.
+ * 
+ * @param x A vector of x-coordinates (independent variable, e.g., years).
+ * @param y A vector of y-coordinates (dependent variable, e.g., temperatures).
+ * @param degree The degree of the polynomial to fit.
+ * @param predict_x A vector of x-coordinates for which predictions are needed.
+ * @return A vector of predicted y-coordinates corresponding to predict_x.
+ */
+std::vector<double> polynomialRegression(const std::vector<int>& x, 
+                                         const std::vector<double>& y, 
+                                         int degree, 
+                                         const std::vector<int>& predict_x) {
+    ScopedTimer timer("regression");
+
+    // Fit in centred, scaled coordinates with pivoted QR (see fitPolynomial)
+    PolynomialFit fit = fitPolynomial(std::vector<double>(x.begin(), x.end()), y, degree);
+
+    std::vector<double> predictions;
+    predictions.reserve(predict_x.size());
+    for (const auto& px : predict_x) {
+        predictions.push_back(fit.evaluate(px));
+    }
+    return predictions;
+}
+
+/**
+ * Predicts and displays temperature trends for a selected country based on historical data.
+ * 
+ * @param data A 2D vector of strings representing the dataset.
+ * @param country_prefix The prefix for the country.
+ * @param startYear The start year of the analysis period.
+ * @param endYear The end year of the analysis period.
+ */
+void predictAndDisplayTemperatures(const std::vector<std::vector<std::string>>& data, 
+                                   const std::string& country_prefix, 
+                                   int startYear, int endYear) {
+    // Compute candlestick data for the selected country
+    auto candlesticks = computeCandlestickData(data, country_prefix, "year");
+    displayTemperaturePrediction(candlesticks, country_prefix, startYear, endYear);
+}
+
+/**
+ * Predicts and displays temperature trends for a selected country from its yearly rollup.
+ *
+ * @param rollups Per-country rollups.
+ * @param country_prefix The prefix for the country.
+ * @param startYear The start year of the analysis period.
+ * @param endYear The end year of the analysis period.
+ * @param out The stream to write to.
+ * @param forecaster The country's forecaster, or nullptr.
+ */
+void predictAndDisplayTemperatures(const std::map<std::string, CandleRollup>& rollups,
+                                   const std::string& country_prefix,
+                                   int startYear, int endYear,
+                                   std::ostream& out,
+                                   const OnlineForecaster* forecaster) {
+    auto candlesticks = findCandleRollup(rollups, country_prefix).candles(TimeFrame::Year);
+    displayTemperaturePrediction(candlesticks, country_prefix, startYear, endYear, out, 0, forecaster);
+}
+
+/**
+ * Fits yearly averages and prints the historical data, the predictions and a
+ * text-based plot.
+ *
+ * @param candlesticks Yearly candlesticks for the selected country.
+ * @param country_prefix The prefix for the country.
+ * @param startYear The start year of the analysis period.
+ * @param endYear The end year of the analysis period.
+ * @param out The stream to write to.
+ * @param max_columns The output width; 0 uses the terminal width.
+ * @param forecaster The country's forecaster, or nullptr.
+ */
+void displayTemperaturePrediction(const std::vector<Candlestick>& candlesticks,
+                                  const std::string& country_prefix,
+                                  int startYear, int endYear,
+                                  std::ostream& out,
+                                  size_t max_columns,
+                                  const OnlineForecaster* forecaster) {
+    // Extract years and average temperatures
+    std::vector<int> years; // To store years
+    std::vector<double> avg_temps; // To store average temperatures
+
+    for (const auto& candle : candlesticks) {
+        int year = std::stoi(candle.date); // Convert date string to year
+        if (year >= startYear && year <= endYear) { // Filter by year range
+            years.push_back(year); // Add year to list
+            avg_temps.push_back((candle.high + candle.low) / 2); // Compute average temperature
+        }
+    }
+
+    // Check if data is available
+    if (years.empty() || avg_temps.empty()) {
+        out << "No data available for the selected country and date range.\n";
+        return;
+    }
+
+    // Define prediction years
+    std::vector<int> predict_years = {years.back() + 1, years.back() + 2, years.back() + 3};
+
+    // Perform polynomial regression to predict temperatures; a forecaster that
+    // has folded in exactly these years already holds the fit
+    auto predictions = forecaster != nullptr && forecaster->degree() == 2 && forecaster->covers(years)
+                           ? forecaster->predict(predict_years)
+                           : polynomialRegression(years, avg_temps, 2, predict_years); // Degree 2 polynomial
+
+    // Display historical data
+    out << "\n--- Historical Temperature Data ---\n";
+    for (size_t i = 0; i < years.size(); ++i) {
+        out << "Year: " << years[i] << ", Avg Temp: " << avg_temps[i] << " degree Celsius\n";
+    }
+
+    // Display predictions
+    out << "\n--- Prediction Summary ---\n";
+    out << "Country: " << country_prefix << "\n";
+    out << "Date Range: " << startYear << " to " << endYear << "\n";
+    out << "Predicted Temperatures for Upcoming Years:\n";
+    for (size_t i = 0; i < predict_years.size(); ++i) {
+        out << "Year: " << predict_years[i] << ", Predicted Temp: " << predictions[i] << " degree Celsius\n";
+    }
+
+    // Visualization: Text-Based Plot
+    // Calculate the minimum and maximum temperatures
+    double min_temp = *std::min_element(avg_temps.begin(), avg_temps.end());
+    double max_temp = *std::max_element(avg_temps.begin(), avg_temps.end());
+    min_temp = std::min(min_temp, *std::min_element(predictions.begin(), predictions.end()));
+    max_temp = std::max(max_temp, *std::max_element(predictions.begin(), predictions.end()));
+
+    // Calculate the range and plot height
+    double range = max_temp - min_temp;
+    int plot_height = 8; // Height of the text-based plot
+    if (range == 0) range = 1; // Prevent division by zero
+
+    out << "\n--- Text-Based Visualization ---\n";
+
+    // Determine the year interval based on the time period
+    int time_period = years.back() - years.front() + 1;
+    int year_interval = (time_period > 20) ? 5 : (time_period > 10 ? 2 : 1);
+
+    // Every year is one two-column cell after the axis, with its mark in the
+    // cell's right column. Only a history wider than the output is thinned,
+    // keeping its LTTB-selected years.
+    const size_t column_width = 2;
+    const size_t axis_width = 9; // "%6.1f |" and one space
+    std::vector<int> plot_years = years;
+    std::vector<double> plot_temps = avg_temps;
+    size_t columns = max_columns > 0 ? max_columns : terminalColumns();
+    // The last label overhangs its cell by one column
+    size_t point_capacity = columns > axis_width + 1 ? (columns - axis_width - 1) / column_width : 0;
+    size_t max_history = point_capacity > predict_years.size() + 2 ? point_capacity - predict_years.size() : 2;
+    if (years.size() > max_history) {
+        std::vector<double> x(years.begin(), years.end());
+        plot_years.clear();
+        plot_temps.clear();
+        for (size_t index : lttbIndices(x, avg_temps, max_history)) {
+            plot_years.push_back(years[index]);
+            plot_temps.push_back(avg_temps[index]);
+        }
+        year_interval = 1;
+    }
+
+    // History then predictions, one cell each; only labelled years are marked
+    std::vector<int> cell_years = plot_years;
+    std::vector<double> cell_temps = plot_temps;
+    cell_years.insert(cell_years.end(), predict_years.begin(), predict_years.end());
+    cell_temps.insert(cell_temps.end(), predictions.begin(), predictions.end());
+
+    // Print the Y-axis and data points
+    for (int i = plot_height; i >= 0; --i) {
+        double temp_level = min_temp + (i * range / plot_height); // Temperature for this level
+        out << std::fixed << std::setprecision(1) << std::setw(6) << temp_level << " | ";
+
+        std::string row(cell_years.size() * column_width, ' ');
+        for (size_t j = 0; j < cell_years.size(); ++j) {
+            double pos = (cell_temps[j] - min_temp) / range * plot_height;
+            if (cell_years[j] % year_interval == 0 && static_cast<int>(std::round(pos)) == i) {
+                // Mark historical (O) and predicted (*) data points
+                row[j * column_width + column_width - 1] = j < plot_years.size() ? 'O' : '*';
+            }
+        }
+        out << row << "\n";
+    }
+
+    // Print X-axis labels: "'YY" with its digits under the mark, skipping any
+    // label that would run into the previous one
+    std::string labels(axis_width + cell_years.size() * column_width + 1, ' ');
+    size_t next_free = 0;
+    for (size_t j = 0; j < cell_years.size(); ++j) {
+        size_t start = axis_width + j * column_width + column_width - 2;
+        if (cell_years[j] % year_interval != 0 || start < next_free) {
+            continue;
+        }
+        int yy = ((cell_years[j] % 100) + 100) % 100;
+        labels[start] = '\'';
+        labels[start + 1] = static_cast<char>('0' + yy / 10);
+        labels[start + 2] = static_cast<char>('0' + yy % 10);
+        next_free = start + 4;
+    }
+    labels.erase(labels.find_last_not_of(' ') + 1);
+    out << labels << "\n";
+}
+
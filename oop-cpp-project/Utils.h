@@ -1,150 +1,329 @@
-#ifndef UTILS_H
-#define UTILS_H
-
-#include <vector>
-#include <string>
-#include "Candlestick.h"
-#include <map>
-
-// --- General Utility Functions ---
-
-/**
- * Reads a CSV file and returns its content as a 2D vector of strings.
- * 
- * @param filename The name of the CSV file to read.
- * @return A 2D vector of strings, where each inner vector represents a row of the file.
- */
-std::vector<std::vector<std::string>> readCSV(const std::string &filename);
-
-// --- Task 1: Candlestick Data Computation ---
-
-/**
- * Computes candlestick data for a given country and time frame.
- * 
- * @param data The dataset as a 2D vector of strings.
- * @param country_prefix The country prefix (e.g., "AT" for Austria).
- * @param time_frame The time frame (e.g., "year", "month", or "day").
- * @return A vector of computed Candlestick objects.
- */
-std::vector<Candlestick> computeCandlestickData(
-    const std::vector<std::vector<std::string>> &data,
-    const std::string &country_prefix,
-    const std::string &time_frame
-);
-
-// --- Task 2: Plotting Functions ---
-/**
- * Plots candlestick data as a text-based graph.
- * 
- * @param candlesticks A vector of Candlestick objects to plot.
- */
-void plotCandlesticks(const std::vector<Candlestick>& candlesticks);
-
-/**
- * Creates a grouped text-based plot of candlestick data.
- * 
- * @param candlesticks A vector of Candlestick objects to plot.
- * @param plot_height The height of the plot.
- */
-void plotGroupedCandlesticks(const std::vector<Candlestick>& candlesticks, int plot_height = 20);
-
-// --- Task 3: Filtering Functions ---
-
-/**
- * Filters candlestick data by a specified date range.
- * 
- * @param candlesticks A vector of Candlestick objects to filter.
- * @param start_date The start date of the range.
- * @param end_date The end date of the range.
- * @return A vector of filtered Candlestick objects.
- */
-std::vector<Candlestick> filterByDateRange(
-    const std::vector<Candlestick>& candlesticks,
-    const std::string& start_date,
-    const std::string& end_date
-);
-
-/**
- * Filters candlestick data by a specified temperature range.
- * 
- * @param candlesticks A vector of Candlestick objects to filter.
- * @param min_temp The minimum temperature.
- * @param max_temp The maximum temperature.
- * @return A vector of filtered Candlestick objects.
- */
-std::vector<Candlestick> filterByTemperatureRange(
-    const std::vector<Candlestick>& candlesticks,
-    double min_temp,
-    double max_temp
-);
-
-/**
- * Filters by a specific country and time frame.
- * 
- * @param data The dataset as a 2D vector of strings.
- * @param country_prefix The country prefix (e.g., "AT" for Austria).
- * @param time_frame The time frame (e.g., "year", "month", or "day").
- * @return A vector of filtered Candlestick objects.
- */
-std::vector<Candlestick> filterByCountry(
-    const std::vector<std::vector<std::string>>& data,
-    const std::string& country_prefix,
-    const std::string& time_frame
-);
-
-// Display Filter Options
-/**
- * Displays available countries in the dataset.
- * 
- * @param data The dataset as a 2D vector of strings.
- */
-void displayAvailableCountries(const std::vector<std::vector<std::string>>& data);
-
-/**
- * Displays the available date range in the dataset.
- * 
- * @param data The dataset as a 2D vector of strings.
- */
-void displayAvailableDateRange(const std::vector<std::vector<std::string>>& data);
-
-/**
- * Displays the available temperature range in the dataset.
- * 
- * @param data The dataset as a 2D vector of strings.
- */
-void displayAvailableTemperatureRange(const std::vector<std::vector<std::string>>& data);
-
-// --- Task 4: Polynomial Regression ---
-
-/**
- * Performs polynomial regression to predict values.
- * 
- * @param x A vector of x-values (e.g., years).
- * @param y A vector of y-values (e.g., temperatures).
- * @param degree The degree of the polynomial to fit.
- * @param predict_x A vector of x-values for which predictions are made.
- * @return A vector of predicted y-values.
- */
-std::vector<double> polynomialRegression(
-    const std::vector<int>& x, 
-    const std::vector<double>& y, 
-    int degree, 
-    const std::vector<int>& predict_x
-);
-
-/**
- * Predicts and displays temperature trends for a given country and date range.
- * 
- * @param data The dataset as a 2D vector of strings.
- * @param country_prefix The country prefix.
- * @param startYear The start year for the prediction.
- * @param endYear The end year for the prediction.
- */
-void predictAndDisplayTemperatures(
-    const std::vector<std::vector<std::string>>& data, 
-    const std::string& country_prefix, 
-    int startYear, 
-    int endYear
-);
-
-#endif // UTILS_H
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <vector>
+#include <string>
+#include "Candlestick.h"
+#include "CandleRollup.h"
+#include "CandlestickRenderer.h"
+#include "OnlineForecaster.h"
+#include "TemperatureIntervalIndex.h"
+#include "TimeFrame.h"
+#include "WeatherTable.h"
+#include <map>
+#include <iostream>
+
+// --- General Utility Functions ---
+
+/**
+ * Reads a CSV file and returns its content as a 2D vector of strings.
+ * 
+ * @param filename The name of the CSV file to read.
+ * @return A 2D vector of strings, where each inner vector represents a row of the file.
+ */
+std::vector<std::vector<std::string>> readCSV(const std::string &filename);
+
+// --- Task 1: Candlestick Data Computation ---
+
+/**
+ * Computes candlestick data for a given country and time frame.
+ * 
+ * A candle's open and close are its earliest and latest readings by
+ * timestamp, whatever the row order.
+ *
+ * @param data The dataset as a 2D vector of strings.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame (e.g., "year", "month", or "day"; see parseTimeFrame).
+ * @return A vector of computed Candlestick objects.
+ * @throws std::runtime_error if the country or time frame is unknown.
+ */
+std::vector<Candlestick> computeCandlestickData(
+    const std::vector<std::vector<std::string>> &data,
+    const std::string &country_prefix,
+    const std::string &time_frame
+);
+
+/**
+ * Computes candlestick data for a given country and time frame from a parsed table.
+ *
+ * Missing temperatures are skipped. A candle's open and close are its
+ * earliest and latest readings by timestamp, whatever the row order.
+ *
+ * @param table The parsed weather table.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame (e.g., TimeFrame::Month or TimeFrameSpec(TimeFrame::HourInterval, 6)).
+ * @return A vector of computed Candlestick objects, ordered by date.
+ * @throws std::runtime_error if the country is unknown.
+ */
+std::vector<Candlestick> computeCandlestickData(
+    const WeatherTable &table,
+    const std::string &country_prefix,
+    const TimeFrameSpec &time_frame
+);
+
+/**
+ * Computes candlestick data from a parsed table, naming the time frame as a string.
+ *
+ * @param table The parsed weather table.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame name (see parseTimeFrame).
+ * @return A vector of computed Candlestick objects, ordered by date.
+ * @throws std::runtime_error if the country or time frame is unknown.
+ */
+std::vector<Candlestick> computeCandlestickData(
+    const WeatherTable &table,
+    const std::string &country_prefix,
+    const std::string &time_frame
+);
+
+/**
+ * Computes candlestick data for several countries in a single pass.
+ *
+ * Each row's time bucket is computed once and reused for every country,
+ * so a report for all countries costs one scan instead of one per country.
+ *
+ * @param table The parsed weather table.
+ * @param time_frame The time frame.
+ * @param country_prefixes The countries to compute; empty means every XX_temperature column.
+ * @return A map from country prefix to its Candlestick objects, ordered by date.
+ * @throws std::runtime_error if a country is unknown.
+ */
+std::map<std::string, std::vector<Candlestick>> computeAllCandlestickData(
+    const WeatherTable &table,
+    const TimeFrameSpec &time_frame,
+    const std::vector<std::string> &country_prefixes = {}
+);
+
+/**
+ * Computes candlestick data for several countries, naming the time frame as a string.
+ *
+ * @param table The parsed weather table.
+ * @param time_frame The time frame name (see parseTimeFrame).
+ * @param country_prefixes The countries to compute; empty means every XX_temperature column.
+ * @return A map from country prefix to its Candlestick objects, ordered by date.
+ * @throws std::runtime_error if a country or the time frame is unknown.
+ */
+std::map<std::string, std::vector<Candlestick>> computeAllCandlestickData(
+    const WeatherTable &table,
+    const std::string &time_frame,
+    const std::vector<std::string> &country_prefixes = {}
+);
+
+// --- Task 2: Plotting Functions ---
+/**
+ * Plots candlestick data as a text-based graph.
+ * 
+ * @param candlesticks A vector of Candlestick objects to plot.
+ */
+void plotCandlesticks(const std::vector<Candlestick>& candlesticks);
+
+/**
+ * Creates a grouped text-based plot of candlestick data.
+ * Series wider than the output are reduced with min/max decimation first, so
+ * every high and low still shows.
+ * 
+ * @param candlesticks A vector of Candlestick objects to plot.
+ * @param plot_height The height of the plot.
+ * @param out The stream to write to.
+ * @param max_columns The output width; 0 uses the terminal width.
+ * @param overlays Indicator lines aligned with the candlesticks (see CandleIndicators::overlays).
+ */
+void plotGroupedCandlesticks(const std::vector<Candlestick>& candlesticks, int plot_height = 20,
+                             std::ostream& out = std::cout, size_t max_columns = 0,
+                             const std::vector<PlotOverlay>& overlays = {});
+
+// --- Task 3: Filtering Functions ---
+
+/**
+ * Filters candlestick data by a specified date range.
+ *
+ * Uses binary search, so the candlesticks must be sorted by date. To chain
+ * several filters without copying in between, use CandleView directly.
+ * 
+ * @param candlesticks A vector of Candlestick objects to filter, sorted by date.
+ * @param start_date The start date of the range.
+ * @param end_date The end date of the range.
+ * @return A vector of filtered Candlestick objects.
+ */
+std::vector<Candlestick> filterByDateRange(
+    const std::vector<Candlestick>& candlesticks,
+    const std::string& start_date,
+    const std::string& end_date
+);
+
+/**
+ * Filters candlestick data by a specified temperature range.
+ * 
+ * @param candlesticks A vector of Candlestick objects to filter.
+ * @param min_temp The minimum temperature.
+ * @param max_temp The maximum temperature.
+ * @return A vector of filtered Candlestick objects.
+ */
+std::vector<Candlestick> filterByTemperatureRange(
+    const std::vector<Candlestick>& candlesticks,
+    double min_temp,
+    double max_temp
+);
+
+/**
+ * Filters candlestick data by a temperature range using a prebuilt interval index.
+ * 
+ * @param index The interval index over the candlesticks to filter.
+ * @param min_temp The minimum temperature.
+ * @param max_temp The maximum temperature.
+ * @return The same candles as the scanning overload, found in O(log n + k).
+ */
+std::vector<Candlestick> filterByTemperatureRange(
+    const TemperatureIntervalIndex& index,
+    double min_temp,
+    double max_temp
+);
+
+/**
+ * Filters by a specific country and time frame.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame (e.g., "year", "month", or "day").
+ * @return A vector of filtered Candlestick objects.
+ */
+std::vector<Candlestick> filterByCountry(
+    const std::vector<std::vector<std::string>>& data,
+    const std::string& country_prefix,
+    const std::string& time_frame
+);
+
+/**
+ * Filters by a specific country and time frame using prebuilt rollups.
+ *
+ * @param rollups Per-country rollups (see buildCandleRollups).
+ * @param country_prefix The country prefix (e.g., "AT" for Austria).
+ * @param time_frame The time frame (e.g., "year", "month", or "day").
+ * @return A vector of filtered Candlestick objects.
+ */
+std::vector<Candlestick> filterByCountry(
+    const std::map<std::string, CandleRollup>& rollups,
+    const std::string& country_prefix,
+    const std::string& time_frame
+);
+
+// Display Filter Options
+/**
+ * Displays available countries in the dataset.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ */
+void displayAvailableCountries(const std::vector<std::vector<std::string>>& data);
+
+/**
+ * Displays available countries in a parsed table.
+ *
+ * @param table The parsed weather table.
+ */
+void displayAvailableCountries(const WeatherTable& table);
+
+/**
+ * Displays the available date range in the dataset.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ */
+void displayAvailableDateRange(const std::vector<std::vector<std::string>>& data);
+
+/**
+ * Displays the available date range in a parsed table.
+ *
+ * @param table The parsed weather table.
+ */
+void displayAvailableDateRange(const WeatherTable& table);
+
+/**
+ * Displays the available temperature range in the dataset.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ */
+void displayAvailableTemperatureRange(const std::vector<std::vector<std::string>>& data);
+
+/**
+ * Displays the available temperature range in a parsed table.
+ *
+ * @param table The parsed weather table.
+ */
+void displayAvailableTemperatureRange(const WeatherTable& table);
+
+// --- Task 4: Polynomial Regression ---
+
+/**
+ * Performs polynomial regression to predict values (a thin wrapper over fitPolynomial).
+ * 
+ * @param x A vector of x-values (e.g., years).
+ * @param y A vector of y-values (e.g., temperatures).
+ * @param degree The degree of the polynomial to fit.
+ * @param predict_x A vector of x-values for which predictions are made.
+ * @return A vector of predicted y-values.
+ */
+std::vector<double> polynomialRegression(
+    const std::vector<int>& x, 
+    const std::vector<double>& y, 
+    int degree, 
+    const std::vector<int>& predict_x
+);
+
+/**
+ * Predicts and displays temperature trends for a given country and date range.
+ * 
+ * @param data The dataset as a 2D vector of strings.
+ * @param country_prefix The country prefix.
+ * @param startYear The start year for the prediction.
+ * @param endYear The end year for the prediction.
+ */
+void predictAndDisplayTemperatures(
+    const std::vector<std::vector<std::string>>& data, 
+    const std::string& country_prefix, 
+    int startYear, 
+    int endYear
+);
+
+/**
+ * Predicts and displays temperature trends for a given country using prebuilt rollups.
+ *
+ * @param rollups Per-country rollups (see buildCandleRollups).
+ * @param country_prefix The country prefix.
+ * @param startYear The start year for the prediction.
+ * @param endYear The end year for the prediction.
+ * @param out The stream to write to.
+ * @param forecaster The country's up-to-date forecaster, if any (see displayTemperaturePrediction).
+ */
+void predictAndDisplayTemperatures(
+    const std::map<std::string, CandleRollup>& rollups,
+    const std::string& country_prefix,
+    int startYear,
+    int endYear,
+    std::ostream& out = std::cout,
+    const OnlineForecaster* forecaster = nullptr
+);
+
+/**
+ * Fits yearly averages and prints the historical data, the predictions and a text-based plot.
+ * Each year takes two columns, labelled "'YY" under its mark wherever a label fits.
+ * A history too long for the output width is plotted from its LTTB-selected years.
+ *
+ * @param candlesticks Yearly candlesticks for the selected country.
+ * @param country_prefix The country prefix.
+ * @param startYear The start year for the prediction.
+ * @param endYear The end year for the prediction.
+ * @param out The stream to write to.
+ * @param max_columns The output width; 0 uses the terminal width.
+ * @param forecaster A degree-2 forecaster for the country. When it covers exactly the
+ *                   window's years, its running fit is used instead of refitting them.
+ */
+void displayTemperaturePrediction(
+    const std::vector<Candlestick>& candlesticks,
+    const std::string& country_prefix,
+    int startYear,
+    int endYear,
+    std::ostream& out = std::cout,
+    size_t max_columns = 0,
+    const OnlineForecaster* forecaster = nullptr
+);
+
+#endif // UTILS_H
@@ -0,0 +1,23 @@
+#include "ValidityBitmap.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Packs !isnan(values[i]) into 64-bit words, counting the valid rows as it goes.
+ *
+ * @param values The column's values.
+ */
+ValidityBitmap::ValidityBitmap(const std::vector<double>& values)
+    : words_((values.size() + 63) / 64, 0), size_(values.size()) {
+    for (size_t w = 0; w < words_.size(); ++w) {
+        const size_t begin = w * 64;
+        const size_t end = std::min(begin + 64, size_);
+        uint64_t word = 0;
+        for (size_t i = begin; i < end; ++i) {
+            word |= uint64_t(!std::isnan(values[i])) << (i - begin);
+        }
+        words_[w] = word;
+        valid_count_ += bitCount(word);
+    }
+}
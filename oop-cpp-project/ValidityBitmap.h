@@ -0,0 +1,92 @@
+#ifndef VALIDITY_BITMAP_H
+#define VALIDITY_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief One bit per row of a column, set where the row holds a parsed value.
+ *
+ * Kernels that scan a column walk the set bits instead of testing every value
+ * for NaN, so long stretches of missing readings (64 rows per word) cost one
+ * comparison each.
+ */
+class ValidityBitmap {
+public:
+    ValidityBitmap() = default;
+
+    /**
+     * @brief Marks every non-NaN value as valid.
+     *
+     * @param values A column as stored in WeatherTable (missing cells are NaN).
+     */
+    explicit ValidityBitmap(const std::vector<double>& values);
+
+    size_t size() const { return size_; }
+    size_t validCount() const { return valid_count_; }
+    size_t invalidCount() const { return size_ - valid_count_; }
+
+    bool valid(size_t row) const { return (words_[row >> 6] >> (row & 63)) & 1; }
+
+    /**
+     * @brief Calls fn(row) for every valid row in [first, last), in order.
+     */
+    template <typename Fn>
+    void forEachValid(size_t first, size_t last, Fn&& fn) const;
+
+private:
+    static unsigned lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+    }
+
+    static unsigned bitCount(uint64_t word) {
+#ifdef _MSC_VER
+        return static_cast<unsigned>(__popcnt64(word));
+#else
+        return static_cast<unsigned>(__builtin_popcountll(word));
+#endif
+    }
+
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+    size_t valid_count_ = 0;
+};
+
+template <typename Fn>
+void ValidityBitmap::forEachValid(size_t first, size_t last, Fn&& fn) const {
+    if (last > size_) {
+        last = size_;
+    }
+    if (first >= last) {
+        return;
+    }
+
+    const size_t first_word = first >> 6;
+    const size_t last_word = (last - 1) >> 6;
+    for (size_t w = first_word; w <= last_word; ++w) {
+        uint64_t word = words_[w];
+        if (w == first_word) {
+            word &= ~uint64_t(0) << (first & 63);
+        }
+        if (w == last_word && (last & 63) != 0) {
+            word &= ~(~uint64_t(0) << (last & 63));
+        }
+        while (word != 0) {
+            fn((w << 6) + lowestBit(word));
+            word &= word - 1; // Clear the lowest set bit
+        }
+    }
+}
+
+#endif // VALIDITY_BITMAP_H
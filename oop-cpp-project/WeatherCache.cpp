@@ -0,0 +1,249 @@
+#include "WeatherCache.h"
+#include "CsvReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kCacheMagic[8] = {'W', 'X', 'C', 'A', 'C', 'H', 'E', '1'};
+const uint32_t kCacheVersion = 2; // 2: cells must parse in full (see parseDouble)
+const size_t kChecksumSpan = 64 * 1024;
+
+/**
+ * Fixed-size part at the start of every cache file.
+ */
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t column_count;  // Header entries, including the timestamp column.
+    uint64_t row_count;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_checksum;
+};
+
+/**
+ * 64-bit FNV-1a over a byte range, continuing from hash.
+ */
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t alignTo8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+} // namespace
+
+/**
+ * Reads the size and modification time of the source and hashes its first
+ * and last 64 KiB.
+ *
+ * @param source_filename The CSV file.
+ * @param info Receives the description.
+ * @return False if the file cannot be read.
+ */
+bool describeCacheSource(const std::string& source_filename, CacheSourceInfo& info) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(source_filename, error);
+    if (error) {
+        return false;
+    }
+    auto mtime = std::filesystem::last_write_time(source_filename, error);
+    if (error) {
+        return false;
+    }
+
+    std::ifstream file(source_filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<char> buffer(std::min<uint64_t>(size, kChecksumSpan));
+    uint64_t hash = 14695981039346656037ULL;
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+
+    if (size > kChecksumSpan) {
+        file.seekg(static_cast<std::streamoff>(size - buffer.size()));
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+
+    info.size = static_cast<uint64_t>(size);
+    info.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    info.checksum = hash;
+    return true;
+}
+
+/**
+ * Serialises the table's schema and raw column arrays.
+ *
+ * @param table The parsed table.
+ * @param cache_filename Where to write the snapshot.
+ * @param source The source the table came from.
+ * @return False on any write error.
+ */
+bool writeWeatherCache(const WeatherTable& table, const std::string& cache_filename, const CacheSourceInfo& source) {
+    const std::string temp_filename = temporaryFileName(cache_filename);
+    std::ofstream file(temp_filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.column_count = static_cast<uint32_t>(table.header.size());
+    header.row_count = table.rowCount();
+    header.source_size = source.size;
+    header.source_mtime = source.mtime;
+    header.source_checksum = source.checksum;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    size_t offset = sizeof(header);
+    for (const auto& name : table.header) {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(name.data(), length);
+        offset += sizeof(length) + length;
+    }
+
+    const char padding[8] = {};
+    file.write(padding, static_cast<std::streamsize>(alignTo8(offset) - offset));
+
+    file.write(reinterpret_cast<const char*>(table.timestamps.data()),
+               static_cast<std::streamsize>(table.timestamps.size() * sizeof(int64_t)));
+    for (const auto& column : table.columns) {
+        file.write(reinterpret_cast<const char*>(column.data()),
+                   static_cast<std::streamsize>(column.size() * sizeof(double)));
+    }
+
+    file.close();
+    if (!file) {
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+
+    if (!replaceFile(temp_filename, cache_filename)) {
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Maps a snapshot, validates it against the source, and copies the arrays out.
+ *
+ * @param cache_filename The snapshot file.
+ * @param source The current state of the source CSV.
+ * @param table Receives the table; untouched on failure.
+ * @return False if the snapshot is missing, corrupt or stale.
+ */
+bool loadWeatherCache(const std::string& cache_filename, const CacheSourceInfo& source, WeatherTable& table) {
+    MappedFile file(cache_filename);
+    if (!file.isOpen() || file.size() < sizeof(CacheHeader)) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    CacheSourceInfo cached_source{header.source_size, header.source_mtime, header.source_checksum};
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        header.version != kCacheVersion || header.column_count == 0 || !(cached_source == source)) {
+        return false;
+    }
+
+    WeatherTable loaded;
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.column_count; ++i) {
+        uint32_t length;
+        if (offset + sizeof(length) > file.size()) {
+            return false;
+        }
+        std::memcpy(&length, file.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > file.size()) {
+            return false;
+        }
+        loaded.header.emplace_back(file.data() + offset, length);
+        offset += length;
+    }
+    offset = alignTo8(offset);
+
+    const uint64_t rows = header.row_count;
+    const uint64_t array_bytes = rows * sizeof(double);
+    if (offset + header.column_count * array_bytes != file.size()) {
+        return false;
+    }
+
+    loaded.timestamps.resize(rows);
+    std::memcpy(loaded.timestamps.data(), file.data() + offset, array_bytes);
+    offset += array_bytes;
+
+    for (size_t i = 1; i < loaded.header.size(); ++i) {
+        loaded.column_index[loaded.header[i]] = loaded.column_names.size();
+        loaded.column_names.push_back(loaded.header[i]);
+
+        std::vector<double> column(rows);
+        std::memcpy(column.data(), file.data() + offset, array_bytes);
+        loaded.columns.push_back(std::move(column));
+        offset += array_bytes;
+    }
+
+    loaded.buildValidity();
+    table = std::move(loaded);
+    return true;
+}
+
+// --- Atomic replacement ---
+
+/**
+ * Combines the process id with a per-process sequence number.
+ *
+ * @param filename The file about to be replaced.
+ * @return The temporary name.
+ */
+std::string temporaryFileName(const std::string& filename) {
+    static std::atomic<unsigned> sequence(0);
+#ifdef _WIN32
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    return filename + "." + std::to_string(pid) + "." + std::to_string(sequence++) + ".tmp";
+}
+
+/**
+ * Renames over the target; on Windows rename() refuses to replace, so MoveFileEx does.
+ *
+ * @param from The temporary file.
+ * @param to The file to replace.
+ * @return False if the target could not be replaced.
+ */
+bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0; // Atomically replaces `to` on POSIX
+#endif
+}
@@ -0,0 +1,82 @@
+#ifndef WEATHER_CACHE_H
+#define WEATHER_CACHE_H
+
+#include "WeatherTable.h"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Identifies the CSV a cache file was built from.
+ *
+ * The checksum covers the first and last 64 KiB of the file, which together
+ * with the size and modification time catches edits and replacements without
+ * reading the whole source.
+ */
+struct CacheSourceInfo {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t checksum = 0;
+
+    bool operator==(const CacheSourceInfo& other) const {
+        return size == other.size && mtime == other.mtime && checksum == other.checksum;
+    }
+};
+
+/**
+ * @brief Describes the current state of a source CSV.
+ *
+ * @param source_filename The CSV file.
+ * @param info Receives its size, modification time and checksum.
+ * @return False if the file cannot be read.
+ */
+bool describeCacheSource(const std::string& source_filename, CacheSourceInfo& info);
+
+/**
+ * @brief Writes a binary snapshot of a table.
+ *
+ * Layout (native byte order): magic "WXCACHE1", version, column count, row
+ * count, source info, the header strings, then the timestamp array and each
+ * column array, 8-byte aligned. The file is written to a temporary name and
+ * renamed into place, so readers never see a partial cache.
+ *
+ * @param table The parsed table.
+ * @param cache_filename Where to write the snapshot.
+ * @param source The source CSV the table was parsed from.
+ * @return False if the file could not be written.
+ */
+bool writeWeatherCache(const WeatherTable& table, const std::string& cache_filename, const CacheSourceInfo& source);
+
+/**
+ * @brief Loads a snapshot written by writeWeatherCache.
+ *
+ * The snapshot is memory-mapped and its arrays are copied straight into the
+ * table; no text is parsed.
+ *
+ * @param cache_filename The snapshot file.
+ * @param source The current state of the source CSV; the snapshot is rejected unless it matches.
+ * @param table Receives the table.
+ * @return False if the snapshot is missing, corrupt or stale.
+ */
+bool loadWeatherCache(const std::string& cache_filename, const CacheSourceInfo& source, WeatherTable& table);
+
+/**
+ * @brief Returns a temporary name next to a file that no other writer of the same file will use.
+ *
+ * @param filename The file about to be replaced.
+ * @return "<filename>.<pid>.<sequence>.tmp".
+ */
+std::string temporaryFileName(const std::string& filename);
+
+/**
+ * @brief Moves a finished temporary file over its target in one step.
+ *
+ * Readers see either the old file or the new one, never neither.
+ *
+ * @param from The temporary file.
+ * @param to The file to replace.
+ * @return False if the target could not be replaced.
+ */
+bool replaceFile(const std::string& from, const std::string& to);
+
+#endif // WEATHER_CACHE_H
@@ -0,0 +1,361 @@
+#include "WeatherTable.h"
+#include "CsvReader.h"
+#include "DateTime.h"
+#include "Instrumentation.h"
+#include "WeatherCache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+// --- WeatherTable ---
+
+/**
+ * Looks up a numeric column by name.
+ *
+ * @param name The column name.
+ * @return The column index, or -1 if absent.
+ */
+int WeatherTable::findColumn(const std::string& name) const {
+    auto it = column_index.find(name);
+    return it == column_index.end() ? -1 : static_cast<int>(it->second);
+}
+
+/**
+ * Returns the XX_temperature column for a country.
+ *
+ * @param country_prefix The country prefix (e.g., "AT").
+ * @return The column's values.
+ */
+const std::vector<double>& WeatherTable::temperatureColumn(const std::string& country_prefix) const {
+    int column = findColumn(country_prefix + "_temperature");
+    if (column == -1) {
+        throw std::runtime_error("Temperature column not found for " + country_prefix);
+    }
+    return columns[column];
+}
+
+/**
+ * Returns the validity bitmap of a country's temperature column.
+ *
+ * @param country_prefix The country prefix (e.g., "AT").
+ * @return The column's bitmap.
+ */
+const ValidityBitmap& WeatherTable::temperatureValidity(const std::string& country_prefix) const {
+    int column = findColumn(country_prefix + "_temperature");
+    if (column == -1) {
+        throw std::runtime_error("Temperature column not found for " + country_prefix);
+    }
+    if (validity.size() != columns.size()) {
+        throw std::runtime_error("Validity bitmaps have not been built");
+    }
+    return validity[column];
+}
+
+void WeatherTable::buildValidity() {
+    validity.clear();
+    validity.reserve(columns.size());
+    for (const auto& column : columns) {
+        validity.emplace_back(column);
+    }
+}
+
+size_t WeatherTable::invalidCellCount() const {
+    size_t count = 0;
+    for (const auto& bitmap : validity) {
+        count += bitmap.invalidCount();
+    }
+    return count;
+}
+
+/**
+ * Lists the country prefixes that have a temperature column.
+ *
+ * @return Prefixes in the order they appear in the header.
+ */
+std::vector<std::string> WeatherTable::countryPrefixes() const {
+    std::vector<std::string> prefixes;
+    for (const auto& name : column_names) {
+        if (name.find("_temperature") != std::string::npos) {
+            prefixes.push_back(name.substr(0, name.find('_')));
+        }
+    }
+    return prefixes;
+}
+
+// --- Loading ---
+
+/**
+ * Parses a cell with std::from_chars, straight from the mapped file: no copy,
+ * no locale lookup, and a bad cell is a return value rather than an exception.
+ *
+ * @param cell The cell text.
+ * @param value Receives the parsed value.
+ * @return False for empty, non-numeric, partly numeric ("12.3.4", "1e") or
+ *         non-finite ("inf", "nan") cells.
+ */
+bool parseDouble(std::string_view cell, double& value) {
+    const char* first = cell.data();
+    const char* last = first + cell.size();
+    while (first != last && (*first == ' ' || *first == '\t')) {
+        ++first;
+    }
+    if (first != last && *first == '+' && last - first > 1 && first[1] != '-') {
+        ++first; // from_chars, unlike strtod, rejects an explicit plus sign
+    }
+
+    while (last != first && (last[-1] == ' ' || last[-1] == '\t')) {
+        --last;
+    }
+
+    // The whole trimmed cell must be the number, or the cell is invalid
+    auto [end, error] = std::from_chars(first, last, value);
+    return error == std::errc() && end != first && end == last && std::isfinite(value);
+}
+
+namespace {
+
+/**
+ * Number of lines in a newline-aligned range. Every line ends with a newline
+ * except possibly the last one of the file.
+ */
+size_t countLines(std::string_view text) {
+    size_t lines = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+    return lines + (!text.empty() && text.back() != '\n' ? 1 : 0);
+}
+
+/**
+ * Parses every data line in text straight into the table's columns, starting
+ * at row `offset`. The columns must already hold countLines(text) rows from
+ * there on. Rows whose timestamp cannot be parsed are skipped, leaving unused
+ * rows at the end of the slice.
+ *
+ * @param text Whole lines of the CSV body.
+ * @param delimiter The cell delimiter.
+ * @param table The table being filled; only rows in this slice are written.
+ * @param offset The first row of this slice.
+ * @return The number of rows written.
+ */
+size_t parseChunk(std::string_view text, char delimiter, WeatherTable& table, size_t offset) {
+    ScopedTimer timer("load.parse_chunk");
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    const size_t column_count = table.columns.size();
+
+    size_t row = offset;
+    size_t invalid_cells = 0; // Counted locally, reported once per chunk
+    std::vector<std::string_view> cells;
+    size_t position = 0;
+    while (position < text.size()) {
+        std::string_view line = CsvReader::nextLine(text, position);
+        if (line.empty()) {
+            continue;
+        }
+        CsvReader::splitRow(line, cells, delimiter);
+
+        int64_t timestamp;
+        if (!parseTimestamp(cells[0], timestamp)) {
+            continue;
+        }
+        table.timestamps[row] = timestamp;
+
+        for (size_t c = 0; c < column_count; ++c) {
+            double value;
+            if (c + 1 < cells.size() && parseDouble(cells[c + 1], value)) {
+                table.columns[c][row] = value;
+            } else {
+                table.columns[c][row] = missing;
+                ++invalid_cells;
+            }
+        }
+        ++row;
+    }
+
+    const size_t rows = row - offset;
+    Instrumentation::add(Counter::RowsRead, rows);
+    Instrumentation::add(Counter::CellsParsed, rows * column_count);
+    Instrumentation::add(Counter::InvalidCells, invalid_cells);
+    return rows;
+}
+
+/**
+ * Splits text into about `count` ranges whose boundaries fall just after a newline.
+ *
+ * @param text The CSV body.
+ * @param count The desired number of ranges.
+ * @return The ranges, in file order, covering all of text.
+ */
+std::vector<std::string_view> splitAtLines(std::string_view text, size_t count) {
+    std::vector<std::string_view> ranges;
+    size_t start = 0;
+
+    for (size_t i = 1; i <= count && start < text.size(); ++i) {
+        size_t end = text.size();
+        if (i < count) {
+            size_t newline = text.find('\n', std::max(start, text.size() * i / count));
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        ranges.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return ranges;
+}
+
+/**
+ * Runs job(i) for i in [0, count) on up to `threads` threads.
+ */
+template <typename Job>
+void runParallel(size_t count, size_t threads, Job job) {
+    if (threads <= 1 || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < count; ++i) {
+        workers.emplace_back(job, i);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Closes the gaps that skipped rows left at the end of each slice, keeping the
+ * slices in file order. Every slice moves down (or stays), so a forward copy
+ * never overwrites unread rows.
+ *
+ * @param table The table whose columns hold the slices.
+ * @param offsets First row of each slice.
+ * @param rows Rows parsed into each slice.
+ */
+void compactSlices(WeatherTable& table, const std::vector<size_t>& offsets, const std::vector<size_t>& rows) {
+    auto close_gaps = [&](auto& column) {
+        size_t write = 0;
+        for (size_t k = 0; k < rows.size(); ++k) {
+            auto first = column.begin() + static_cast<std::ptrdiff_t>(offsets[k]);
+            if (offsets[k] != write) {
+                std::copy(first, first + static_cast<std::ptrdiff_t>(rows[k]), column.begin() + write);
+            }
+            write += rows[k];
+        }
+        column.resize(write);
+    };
+
+    close_gaps(table.timestamps);
+    for (auto& column : table.columns) {
+        close_gaps(column);
+    }
+}
+
+} // namespace
+
+/**
+ * Parses an open CSV into typed columns. The body is cut into newline-aligned
+ * byte ranges, one per thread. Each column is allocated once, with one row per
+ * line of the body, and every thread parses its range straight into its own
+ * slice of it; no per-chunk buffers are built and copied. Rows that were
+ * skipped leave gaps, which are closed afterwards.
+ *
+ * @param reader An open CsvReader.
+ * @param options Loader options (thread count).
+ * @return The parsed table.
+ */
+WeatherTable loadWeatherTable(const CsvReader& reader, const LoadOptions& options) {
+    WeatherTable table;
+    std::string_view text = reader.contents();
+
+    // Header
+    size_t body_start = 0;
+    std::string_view header_line;
+    while (header_line.empty() && body_start < text.size()) {
+        header_line = CsvReader::nextLine(text, body_start);
+    }
+    if (header_line.empty()) {
+        return table;
+    }
+
+    std::vector<std::string_view> cells;
+    CsvReader::splitRow(header_line, cells, reader.delimiter());
+    for (size_t i = 0; i < cells.size(); ++i) {
+        table.header.emplace_back(cells[i]);
+        if (i > 0) {
+            table.column_index[table.header.back()] = table.column_names.size();
+            table.column_names.push_back(table.header.back());
+        }
+    }
+    const size_t column_count = table.column_names.size();
+
+    // Size every slice by its line count, then allocate each column once
+    size_t threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::string_view body = text.substr(std::min(body_start, text.size()));
+    std::vector<std::string_view> ranges = splitAtLines(body, threads);
+    std::vector<size_t> offsets(ranges.size() + 1, 0);
+
+    runParallel(ranges.size(), threads, [&](size_t i) { offsets[i + 1] = countLines(ranges[i]); });
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    table.timestamps.resize(offsets.back());
+    table.columns.assign(column_count, std::vector<double>(offsets.back()));
+    Instrumentation::add(Counter::BytesAllocated, offsets.back() * (sizeof(int64_t) + column_count * sizeof(double)));
+
+    // Parse the body, one slice per thread
+    std::vector<size_t> rows(ranges.size(), 0);
+    {
+        ScopedTimer timer("load.parse");
+        runParallel(ranges.size(), threads, [&](size_t i) {
+            rows[i] = parseChunk(ranges[i], reader.delimiter(), table, offsets[i]);
+        });
+    }
+
+    // Rows stay in file order whatever the thread count
+    {
+        ScopedTimer timer("load.compact");
+        compactSlices(table, offsets, rows);
+    }
+
+    ScopedTimer timer("load.validity");
+    table.buildValidity();
+    return table;
+}
+
+/**
+ * Opens, maps and parses a weather CSV file, going through the binary
+ * snapshot when one is configured.
+ *
+ * @param filename The name of the CSV file.
+ * @param options Loader options (thread count).
+ * @return The parsed table; empty on failure.
+ */
+WeatherTable loadWeatherTable(const std::string& filename, const LoadOptions& options) {
+    CacheSourceInfo source;
+    bool use_cache = !options.cache_file.empty() && describeCacheSource(filename, source);
+
+    WeatherTable table;
+    if (use_cache && !options.rebuild_cache) {
+        ScopedTimer timer("load.cache_read");
+        if (loadWeatherCache(options.cache_file, source, table)) {
+            Instrumentation::add(Counter::RowsRead, table.rowCount());
+            return table;
+        }
+    }
+
+    CsvReader reader(filename);
+    if (!reader.isOpen()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return {};
+    }
+    table = loadWeatherTable(reader, options);
+
+    ScopedTimer timer("load.cache_write");
+    if (use_cache && !table.empty() && !writeWeatherCache(table, options.cache_file, source)) {
+        std::cerr << "Warning: Could not write cache file " << options.cache_file << std::endl;
+    }
+    return table;
+}
@@ -0,0 +1,137 @@
+#ifndef WEATHER_TABLE_H
+#define WEATHER_TABLE_H
+
+#include "ValidityBitmap.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class CsvReader;
+
+/**
+ * @brief Typed, column-oriented view of the weather dataset.
+ *
+ * The CSV is parsed exactly once: the timestamp column becomes epoch seconds
+ * and every other column (XX_temperature, XX_radiation_*) becomes a contiguous
+ * array of doubles. Missing or unparseable cells are stored as NaN and are
+ * also cleared in the column's validity bitmap, which scanning kernels use to
+ * skip them. Column names are resolved to indices once, at load time.
+ */
+struct WeatherTable {
+    std::vector<std::string> header;            // Header row as read from the file.
+    std::vector<int64_t> timestamps;            // utc_timestamp as epoch seconds, one per row.
+    std::vector<std::string> column_names;      // Names of the numeric columns, in file order.
+    std::vector<std::vector<double>> columns;   // One array per numeric column, rowCount() long.
+    std::map<std::string, size_t> column_index; // Column name -> index into columns.
+    std::vector<ValidityBitmap> validity;       // One per column; see buildValidity.
+
+    size_t rowCount() const { return timestamps.size(); }
+    bool empty() const { return timestamps.empty(); }
+
+    /**
+     * @brief Looks up a numeric column by name.
+     *
+     * @param name The column name (e.g., "AT_temperature").
+     * @return The index into columns, or -1 if there is no such column.
+     */
+    int findColumn(const std::string& name) const;
+
+    /**
+     * @brief Returns the temperature column of a country.
+     *
+     * @param country_prefix The country prefix (e.g., "AT" for Austria).
+     * @return The column's values.
+     * @throws std::runtime_error if the dataset has no such column.
+     */
+    const std::vector<double>& temperatureColumn(const std::string& country_prefix) const;
+
+    /**
+     * @brief Returns the validity bitmap of a country's temperature column.
+     *
+     * @param country_prefix The country prefix (e.g., "AT" for Austria).
+     * @throws std::runtime_error if the dataset has no such column.
+     */
+    const ValidityBitmap& temperatureValidity(const std::string& country_prefix) const;
+
+    /**
+     * @brief Rebuilds every column's validity bitmap from its NaNs.
+     *
+     * The loaders call this; code that fills columns by hand must call it too.
+     */
+    void buildValidity();
+
+    /**
+     * @brief Number of missing cells across all columns.
+     */
+    size_t invalidCellCount() const;
+
+    /**
+     * @brief Lists the prefixes of every XX_temperature column, in file order.
+     */
+    std::vector<std::string> countryPrefixes() const;
+};
+
+/**
+ * @brief Parses a cell as a double without throwing or allocating.
+ *
+ * Leading and trailing blanks and a leading '+' are accepted. Unlike
+ * std::stod, the whole cell must be the number: "12.3.4" and "1e" are invalid,
+ * not 12.3 and 1.
+ *
+ * @param cell The cell text.
+ * @param value Receives the parsed value.
+ * @return False if the cell is empty, not entirely a number, or not finite.
+ */
+bool parseDouble(std::string_view cell, double& value);
+
+/**
+ * @brief Options for loadWeatherTable.
+ */
+struct LoadOptions {
+    /**
+     * Number of parser threads. 1 parses on the calling thread; 0 uses one
+     * thread per hardware core. The file is split into newline-aligned chunks,
+     * one per thread.
+     */
+    unsigned threads = 1;
+
+    /**
+     * Binary snapshot to use when loading by filename (see WeatherCache.h).
+     * Empty disables caching. A snapshot that matches the source CSV is loaded
+     * instead of parsing; otherwise the CSV is parsed and the snapshot rewritten.
+     */
+    std::string cache_file;
+
+    /** Ignore any existing snapshot and rebuild it from the CSV. */
+    bool rebuild_cache = false;
+};
+
+/**
+ * @brief Parses an already opened CSV into a WeatherTable.
+ *
+ * The first row is taken as the header and the first column as utc_timestamp.
+ * Rows whose timestamp cannot be parsed are skipped. With several threads the
+ * result is identical to the single-threaded one: rows keep their file order.
+ *
+ * @param reader An open CsvReader over the weather file.
+ * @param options Loader options (thread count).
+ * @return The parsed table; empty if the file has no data rows.
+ */
+WeatherTable loadWeatherTable(const CsvReader& reader, const LoadOptions& options = LoadOptions());
+
+/**
+ * @brief Reads and parses a weather CSV file into a WeatherTable.
+ *
+ * When options.cache_file is set, a matching binary snapshot is used instead
+ * of parsing, and a stale or missing one is (re)written after parsing.
+ *
+ * @param filename The name of the CSV file.
+ * @param options Loader options (thread count).
+ * @return The parsed table; empty if the file could not be read.
+ */
+WeatherTable loadWeatherTable(const std::string& filename, const LoadOptions& options = LoadOptions());
+
+#endif // WEATHER_TABLE_H
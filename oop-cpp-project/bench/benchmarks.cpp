@@ -0,0 +1,395 @@
+/**
+ * Throughput benchmarks for the hot paths of candlestick_tool.
+ *
+ * Each benchmark runs its body --repeat times and reports the fastest run as
+ * rows/s and bytes/s, along with the process's peak resident set size after
+ * the benchmark. Peak RSS is a high-water mark, so streaming runs before the
+ * file is mapped or the table is loaded, and the memory-hungry legacy
+ * benchmarks run last.
+ *
+ * Usage:
+ *   bench_candles [--file CSV] [--repeat N] [--threads N] [--only SUBSTRING] [--csv]
+ *
+ * Generate inputs with generate_weather (see README.md).
+ */
+
+#include "../CandleRollup.h"
+#include "../CandlestickAggregator.h"
+#include "../CandlestickRenderer.h"
+#include "../ColumnAggregation.h"
+#include "../Correlation.h"
+#include "../CsvReader.h"
+#include "../DateTime.h"
+#include "../Indicators.h"
+#include "../RangeQueryIndex.h"
+#include "../Regression.h"
+#include "../TemperatureIntervalIndex.h"
+#include "../Utils.h"
+#include "../WeatherCache.h"
+#include "../WeatherTable.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct Options {
+    std::string file = "weather_data.csv";
+    int repeat = 3;
+    unsigned threads = 0;
+    std::string only;
+    bool csv = false;
+};
+
+struct Result {
+    std::string name;
+    double seconds;
+    double rows;
+    double bytes;
+    double peak_rss_mib;
+};
+
+/**
+ * Peak resident set size of this process in MiB.
+ */
+double peakRssMiB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0; // KiB
+#endif
+#endif
+}
+
+/**
+ * Swallows output, so per-row diagnostics do not dominate the timings.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    /**
+     * Times body() and records the fastest of --repeat runs.
+     *
+     * @param name The benchmark name.
+     * @param rows Rows (or items) processed per run.
+     * @param bytes Input bytes touched per run.
+     * @param body The work to time.
+     */
+    void run(const std::string& name, double rows, double bytes, const std::function<void()>& body) {
+        if (!options_.only.empty() && name.find(options_.only) == std::string::npos) {
+            return;
+        }
+
+        NullBuffer null_buffer;
+        std::streambuf* saved = std::cerr.rdbuf(&null_buffer);
+        double best = 1e300;
+        for (int i = 0; i < options_.repeat; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            body();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        std::cerr.rdbuf(saved);
+
+        results_.push_back({name, best, rows, bytes, peakRssMiB()});
+        print(results_.back());
+    }
+
+    void printHeader() const {
+        if (options_.csv) {
+            std::printf("benchmark,seconds,rows_per_s,bytes_per_s,peak_rss_mib\n");
+        } else {
+            std::printf("%-28s %10s %14s %12s %10s\n", "benchmark", "best ms", "rows/s", "MB/s", "peak MiB");
+        }
+    }
+
+private:
+    void print(const Result& result) const {
+        double rows_per_second = result.rows / result.seconds;
+        double bytes_per_second = result.bytes / result.seconds;
+        if (options_.csv) {
+            std::printf("%s,%.6f,%.0f,%.0f,%.1f\n", result.name.c_str(), result.seconds, rows_per_second,
+                        bytes_per_second, result.peak_rss_mib);
+        } else {
+            std::printf("%-28s %10.2f %14.0f %12.1f %10.1f\n", result.name.c_str(), result.seconds * 1e3,
+                        rows_per_second, bytes_per_second / 1e6, result.peak_rss_mib);
+        }
+        std::fflush(stdout);
+    }
+
+    const Options& options_;
+    std::vector<Result> results_;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--csv") {
+            options.csv = true;
+        } else if (i + 1 < argc && arg == "--file") {
+            options.file = argv[++i];
+        } else if (i + 1 < argc && arg == "--repeat") {
+            options.repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (i + 1 < argc && arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (i + 1 < argc && arg == "--only") {
+            options.only = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+volatile double sink = 0.0; // Keeps results observable so the optimiser cannot drop the work
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s [--file CSV] [--repeat N] [--threads N] [--only SUBSTRING] [--csv]\n", argv[0]);
+        return 1;
+    }
+
+    // The shape, first country and row count come from a streaming pass, so
+    // stream_candles_year runs before anything maps the file
+    std::vector<std::string> header;
+    double rows = -1.0; // Less the header
+    {
+        CsvStreamReader stream(options.file);
+        if (!stream.isOpen()) {
+            std::fprintf(stderr, "Error: Could not open %s\n", options.file.c_str());
+            return 1;
+        }
+        std::vector<std::string_view> cells;
+        for (; stream.nextRow(cells); rows += 1.0) {
+            if (header.empty()) {
+                header.assign(cells.begin(), cells.end());
+            }
+        }
+    }
+    std::string country;
+    for (const auto& name : header) {
+        if (country.empty() && name.find("_temperature") != std::string::npos) {
+            country = name.substr(0, name.find('_'));
+        }
+    }
+    if (country.empty() || rows < 1) {
+        std::fprintf(stderr, "Error: %s has no temperature column or no data rows\n", options.file.c_str());
+        return 1;
+    }
+
+    const double file_bytes = static_cast<double>(std::filesystem::file_size(options.file));
+    const double column_bytes = rows * (sizeof(int64_t) + sizeof(double)); // Timestamps plus one column
+    // The banner goes to stderr under --csv so stdout stays parseable.
+    std::fprintf(options.csv ? stderr : stdout, "%s: %.0f rows, %zu columns, %.1f MB; repeat %d\n\n",
+                 options.file.c_str(), rows, header.size() - 1, file_bytes / 1e6, options.repeat);
+
+    Runner runner(options);
+    runner.printHeader();
+
+    // --- Ingest ---
+
+    // Constant-memory candles through a read window; compare its peak MiB with load_table_*
+    runner.run("stream_candles_year", rows, file_bytes, [&]() {
+        size_t candles = streamCandlestickData(options.file, country, TimeFrame::Year, [](const Candlestick&) {});
+        sink = sink + static_cast<double>(candles);
+    });
+
+    CsvReader reader(options.file);
+    if (!reader.isOpen()) {
+        std::fprintf(stderr, "Error: Could not open %s\n", options.file.c_str());
+        return 1;
+    }
+
+    LoadOptions load_options;
+    load_options.threads = options.threads;
+    WeatherTable table = loadWeatherTable(reader, load_options);
+    if (table.empty()) {
+        std::fprintf(stderr, "Error: %s has no data rows\n", options.file.c_str());
+        return 1;
+    }
+
+    runner.run("csv_scan", rows, file_bytes, [&]() {
+        size_t cells = 0;
+        reader.forEachRow([&cells](size_t, const std::vector<std::string_view>& row) { cells += row.size(); });
+        sink = sink + static_cast<double>(cells);
+    });
+
+    LoadOptions single_thread;
+    single_thread.threads = 1;
+    runner.run("load_table_1_thread", rows, file_bytes, [&]() {
+        sink = sink + static_cast<double>(loadWeatherTable(reader, single_thread).rowCount());
+    });
+    runner.run("load_table_all_threads", rows, file_bytes, [&]() {
+        sink = sink + static_cast<double>(loadWeatherTable(reader, load_options).rowCount());
+    });
+
+    const std::string cache_file = options.file + ".bench.cache";
+    CacheSourceInfo source;
+    describeCacheSource(options.file, source);
+    runner.run("cache_write", rows, file_bytes, [&]() {
+        sink = sink + (writeWeatherCache(table, cache_file, source) ? 1.0 : 0.0);
+    });
+    writeWeatherCache(table, cache_file, source); // cache_load may run on its own under --only
+    runner.run("cache_load", rows, file_bytes, [&]() {
+        WeatherTable cached;
+        sink = sink + (loadWeatherCache(cache_file, source, cached) ? 1.0 : 0.0);
+    });
+    std::remove(cache_file.c_str());
+
+    // --- Aggregation ---
+
+    for (const char* frame : {"hour", "day", "month", "year"}) {
+        runner.run(std::string("candles_") + frame, rows, column_bytes, [&]() {
+            sink = sink + static_cast<double>(computeCandlestickData(table, country, frame).size());
+        });
+    }
+
+    const double all_bytes = rows * (sizeof(int64_t) + sizeof(double) * table.countryPrefixes().size());
+    runner.run("candles_all_countries_day", rows, all_bytes, [&]() {
+        sink = sink + static_cast<double>(computeAllCandlestickData(table, "day").size());
+    });
+    const double table_bytes = rows * (sizeof(int64_t) + sizeof(double) * table.columns.size());
+    runner.run("aggregate_all_columns_day", rows, table_bytes, [&]() {
+        sink = sink + static_cast<double>(aggregateColumns(table, TimeFrame::Day).bucketCount());
+    });
+    const std::vector<std::string> temperature_columns = selectCorrelationColumns(table, {});
+    const double temperature_bytes = rows * temperature_columns.size() * sizeof(double);
+    runner.run("correlation_all_countries", rows, temperature_bytes, [&]() {
+        sink = sink + correlateColumns(table, temperature_columns, options.threads).correlation[1];
+    });
+    runner.run("rollup_build", rows, column_bytes, [&]() {
+        sink = sink + static_cast<double>(CandleRollup(table, country).size(TimeFrame::Day));
+    });
+    runner.run("rollup_build_quantiles", rows, column_bytes, [&]() {
+        sink = sink + static_cast<double>(CandleRollup(table, country, true).size(TimeFrame::Day));
+    });
+    CandleRollup sketched(table, country, true);
+    runner.run("quantiles_month", rows, column_bytes, [&]() {
+        sink = sink + sketched.quantiles(TimeFrame::Month, {0.05, 0.5, 0.95}).values.back();
+    });
+
+    // --- Filtering and queries ---
+
+    std::vector<Candlestick> daily = computeCandlestickData(table, country, "day");
+    const double daily_rows = static_cast<double>(daily.size());
+    const double daily_bytes = daily_rows * sizeof(Candlestick);
+    std::string middle_date = daily[daily.size() / 2].date;
+
+    runner.run("filter_date_range", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(filterByDateRange(daily, daily.front().date, middle_date).size());
+    });
+    runner.run("filter_temperature_range", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(filterByTemperatureRange(daily, 0.0, 15.0).size());
+    });
+    runner.run("interval_index_build", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(TemperatureIntervalIndex(daily).size());
+    });
+    TemperatureIntervalIndex temperature_index(daily);
+    runner.run("filter_temps_indexed", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(filterByTemperatureRange(temperature_index, 0.0, 15.0).size());
+    });
+    runner.run("filter_temps_narrow", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(filterByTemperatureRange(daily, 24.0, 26.0).size());
+    });
+    runner.run("filter_temps_narrow_indexed", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(filterByTemperatureRange(temperature_index, 24.0, 26.0).size());
+    });
+    const std::vector<IndicatorSpec> indicator_specs = {parseIndicator("sma50"), parseIndicator("ema20"),
+                                                         parseIndicator("bb20"), parseIndicator("atr14"),
+                                                         parseIndicator("donchian365")};
+    runner.run("indicators_daily_x5", daily_rows, daily_bytes, [&]() {
+        CandleIndicators indicators(indicator_specs, daily);
+        sink = sink + indicators.series(indicators.seriesCount() - 1).back();
+    });
+
+    RangeQueryIndex range_index(table, country);
+    const int queries = 100000;
+    runner.run("range_query_x100k", queries, queries * 2.0 * sizeof(int64_t), [&]() {
+        double total = 0.0;
+        int64_t first = table.timestamps.front();
+        int64_t span = table.timestamps.back() - first + 1;
+        for (int i = 0; i < queries; ++i) {
+            int64_t start = first + (static_cast<int64_t>(i) * 7919 * 3600) % span;
+            total += range_index.query(start, start + 30 * 86400).high;
+        }
+        sink = sink + total;
+    });
+
+    // --- Regression and rendering ---
+
+    std::vector<double> x(static_cast<size_t>(rows)), y(static_cast<size_t>(rows));
+    const std::vector<double>& temperatures = table.temperatureColumn(country);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = 1980.0 + static_cast<double>(i) / 8766.0;
+        y[i] = temperatures[i] == temperatures[i] ? temperatures[i] : 0.0;
+    }
+    runner.run("polynomial_fit_deg3", rows, rows * 2 * sizeof(double), [&]() {
+        sink = sink + fitPolynomial(x, y, 3).rms_error;
+    });
+
+    // Every country x four trailing windows x degrees 1-3, as a predict-sweep query runs it
+    std::vector<RegressionJob> sweep;
+    const int last_year = civilFromEpoch(table.timestamps.back()).year;
+    for (const auto& prefix : table.countryPrefixes()) {
+        for (int span : {5, 10, 20, 40}) {
+            for (int degree = 1; degree <= 3; ++degree) {
+                sweep.push_back({prefix, last_year - span + 1, last_year, degree, 3});
+            }
+        }
+    }
+    runner.run("regression_sweep", static_cast<double>(sweep.size()), rows * sizeof(double), [&]() {
+        sink = sink + runRegressionBatch(table, sweep, options.threads).back().fit.rms_error;
+    });
+
+    runner.run("render_daily_plot", daily_rows, daily_bytes, [&]() {
+        sink = sink + static_cast<double>(CandlestickRenderer(20).render(daily).size());
+    });
+
+    // --- Legacy row-of-strings path (largest memory footprint, so last) ---
+
+    std::vector<std::vector<std::string>> text_rows;
+    runner.run("read_csv_legacy", rows, file_bytes, [&]() {
+        text_rows = readCSV(options.file);
+        sink = sink + static_cast<double>(text_rows.size());
+    });
+    if (!text_rows.empty()) {
+        runner.run("candles_legacy_year", rows, file_bytes, [&]() {
+            sink = sink + static_cast<double>(computeCandlestickData(text_rows, country, "year").size());
+        });
+    }
+
+    return 0;
+}
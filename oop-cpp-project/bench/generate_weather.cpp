@@ -0,0 +1,265 @@
+/**
+ * Deterministic generator for weather-shaped CSV files.
+ *
+ * Writes utc_timestamp plus, per country, XX_temperature,
+ * XX_radiation_direct_horizontal and XX_radiation_diffuse_horizontal at one
+ * row per hour from 1980-01-01T00:00:00Z. The same arguments always produce
+ * the same file: values come from a seeded splitmix64 stream and are formatted
+ * with integer arithmetic, not locale-dependent printf.
+ *
+ * Usage:
+ *   generate_weather [--rows N] [--countries N] [--bad-fraction F] [--seed S] [--output FILE]
+ */
+
+#include "../DateTime.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Prefixes of the real dataset, so generated files exercise the same lookups.
+const char* const kCountries[] = {
+    "AT", "BE", "BG", "CH", "CZ", "DE", "DK", "EE", "ES", "FI", "FR", "GB", "GR", "HR",
+    "HU", "IE", "IT", "LT", "LU", "LV", "NL", "NO", "PL", "PT", "RO", "SE", "SI", "SK",
+};
+const size_t kCountryCount = sizeof(kCountries) / sizeof(kCountries[0]);
+const double kPi = 3.14159265358979323846;
+
+struct Options {
+    uint64_t rows = 100000;
+    size_t countries = 28;
+    double bad_fraction = 0.0;
+    uint64_t seed = 42;
+    std::string output = "weather_data.csv";
+};
+
+/**
+ * splitmix64: tiny, fast and identical on every platform.
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /** Uniform in [0, 1). */
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    /** Roughly standard normal (Irwin-Hall with four uniforms). */
+    double normal() { return (uniform() + uniform() + uniform() + uniform() - 2.0) * 1.7320508075688772; }
+
+private:
+    uint64_t state_;
+};
+
+/**
+ * Buffered writer with integer-based fixed-point formatting.
+ */
+class Writer {
+public:
+    explicit Writer(FILE* file) : file_(file) { buffer_.reserve(kCapacity + 256); }
+    ~Writer() { flush(); }
+
+    void put(char c) { buffer_ += c; }
+    void put(const char* text) { buffer_ += text; }
+
+    /** Writes value rounded to three decimals, trimming trailing zeros like the source data. */
+    void putFixed3(double value) {
+        int64_t scaled = static_cast<int64_t>(std::llround(value * 1000.0));
+        if (scaled < 0) {
+            buffer_ += '-';
+            scaled = -scaled;
+        }
+        putUnsigned(static_cast<uint64_t>(scaled / 1000));
+        int fraction = static_cast<int>(scaled % 1000);
+        if (fraction != 0) {
+            char digits[4] = {static_cast<char>('0' + fraction / 100), static_cast<char>('0' + fraction / 10 % 10),
+                              static_cast<char>('0' + fraction % 10), 0};
+            int length = 3;
+            while (digits[length - 1] == '0') {
+                digits[--length] = 0;
+            }
+            buffer_ += '.';
+            buffer_ += digits;
+        }
+    }
+
+    void putPadded(int value, int width) {
+        char digits[16];
+        for (int i = width - 1; i >= 0; --i) {
+            digits[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        buffer_.append(digits, static_cast<size_t>(width));
+    }
+
+    void endLine() {
+        buffer_ += '\n';
+        if (buffer_.size() >= kCapacity) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (!buffer_.empty()) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            buffer_.clear();
+        }
+    }
+
+private:
+    static const size_t kCapacity = 1 << 20;
+
+    void putUnsigned(uint64_t value) {
+        char digits[24];
+        int length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (length > 0) {
+            buffer_ += digits[--length];
+        }
+    }
+
+    FILE* file_;
+    std::string buffer_;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--rows N] [--countries N] [--bad-fraction F] [--seed S] [--output FILE]\n"
+                 "  --rows N          data rows, one per hour (default 100000)\n"
+                 "  --countries N     countries, 1-%zu (default %zu)\n"
+                 "  --bad-fraction F  share of data cells left empty or malformed, 0-1 (default 0)\n"
+                 "  --seed S          random seed (default 42)\n"
+                 "  --output FILE     output path (default weather_data.csv)\n",
+                 program, kCountryCount, kCountryCount);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--rows") {
+            options.rows = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--countries") {
+            options.countries = static_cast<size_t>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--bad-fraction") {
+            options.bad_fraction = std::strtod(value, nullptr);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return options.countries >= 1 && options.countries <= kCountryCount &&
+           options.bad_fraction >= 0.0 && options.bad_fraction <= 1.0;
+}
+
+/**
+ * Writes a bad cell: mostly empty, sometimes text the parser must reject.
+ */
+void putBadCell(Writer& writer, Random& random) {
+    static const char* const kMalformed[] = {"n/a", "--", "12.3.4", "NaNx", "1e"};
+    if (random.uniform() < 0.5) {
+        writer.put(kMalformed[random.next() % 5]);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* file = std::fopen(options.output.c_str(), "wb");
+    if (!file) {
+        std::fprintf(stderr, "Error: Could not open %s for writing\n", options.output.c_str());
+        return 1;
+    }
+
+    Random random(options.seed);
+    Writer writer(file);
+
+    writer.put("utc_timestamp");
+    for (size_t c = 0; c < options.countries; ++c) {
+        for (const char* suffix : {"_temperature", "_radiation_direct_horizontal", "_radiation_diffuse_horizontal"}) {
+            writer.put(',');
+            writer.put(kCountries[c]);
+            writer.put(suffix);
+        }
+    }
+    writer.endLine();
+
+    // Per-country climate: mean temperature, seasonal swing, and a phase offset.
+    std::vector<double> mean(options.countries), swing(options.countries), phase(options.countries);
+    for (size_t c = 0; c < options.countries; ++c) {
+        mean[c] = 4.0 + 12.0 * random.uniform();
+        swing[c] = 6.0 + 8.0 * random.uniform();
+        phase[c] = 0.2 * random.uniform();
+    }
+
+    const int64_t start = daysFromCivil(1980, 1, 1) * 86400;
+    for (uint64_t row = 0; row < options.rows; ++row) {
+        int64_t epoch = start + static_cast<int64_t>(row) * 3600;
+        CivilTime civil = civilFromEpoch(epoch);
+        writer.putPadded(civil.year, 4);
+        writer.put('-');
+        writer.putPadded(civil.month, 2);
+        writer.put('-');
+        writer.putPadded(civil.day, 2);
+        writer.put('T');
+        writer.putPadded(civil.hour, 2);
+        writer.put(":00:00Z");
+
+        double year_fraction = static_cast<double>(row % 8766) / 8766.0;
+        double day_fraction = static_cast<double>(civil.hour) / 24.0;
+        double daylight = std::sin(kPi * (day_fraction - 0.25) * 2.0);
+
+        for (size_t c = 0; c < options.countries; ++c) {
+            double season = -std::cos(2.0 * kPi * (year_fraction - phase[c]));
+            double values[3] = {
+                mean[c] + swing[c] * season + 4.0 * daylight + 1.5 * random.normal(),
+                std::max(0.0, (450.0 + 250.0 * season) * daylight + 40.0 * random.normal()),
+                std::max(0.0, (120.0 + 60.0 * season) * daylight + 15.0 * random.normal()),
+            };
+            for (double value : values) {
+                writer.put(',');
+                if (options.bad_fraction > 0.0 && random.uniform() < options.bad_fraction) {
+                    putBadCell(writer, random);
+                } else {
+                    writer.putFixed3(value);
+                }
+            }
+        }
+        writer.endLine();
+    }
+
+    writer.flush();
+    if (std::fclose(file) != 0) {
+        std::fprintf(stderr, "Error: Failed to write %s\n", options.output.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1250 @@
+/**
+ * Consistency checks for the indexed, precomputed and incremental paths of candlestick_tool.
+ *
+ * Each check runs a fast path and the naive computation it replaces on the
+ * same seeded random input, and prints PASS, or FAIL with the first mismatch.
+ * Table checks load generated hourly CSVs from the temporary directory. The
+ * exit status is 1 if any check failed.
+ *
+ * Usage:
+ *   self_check [--seed N] [--only SUBSTRING]
+ */
+
+#include "../CandleRollup.h"
+#include "../CandleView.h"
+#include "../CandlestickAggregator.h"
+#include "../ColumnAggregation.h"
+#include "../Correlation.h"
+#include "../CsvReader.h"
+#include "../DateTime.h"
+#include "../Indicators.h"
+#include "../OnlineForecaster.h"
+#include "../QuantileSketch.h"
+#include "../RangeQueryIndex.h"
+#include "../Regression.h"
+#include "../TemperatureIntervalIndex.h"
+#include "../Utils.h"
+#include "../WeatherTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint64_t seed = 42;
+    std::string only;
+};
+
+class Checker {
+public:
+    explicit Checker(const Options& options) : options_(options) {}
+
+    /**
+     * Runs one check and prints its outcome.
+     *
+     * @param name The check name.
+     * @param body Returns an empty string on success, or a description of the first mismatch.
+     */
+    void check(const std::string& name, const std::function<std::string()>& body) {
+        if (!options_.only.empty() && name.find(options_.only) == std::string::npos) {
+            return;
+        }
+
+        std::string mismatch;
+        try {
+            mismatch = body();
+        } catch (const std::exception& e) {
+            mismatch = std::string("threw ") + e.what();
+        }
+        ++checks_;
+        if (mismatch.empty()) {
+            std::printf("PASS %s\n", name.c_str());
+        } else {
+            ++failures_;
+            std::printf("FAIL %s: %s\n", name.c_str(), mismatch.c_str());
+        }
+        std::fflush(stdout);
+    }
+
+    int checks() const { return checks_; }
+    int failures() const { return failures_; }
+
+private:
+    const Options& options_;
+    int checks_ = 0;
+    int failures_ = 0;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--seed") {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && arg == "--only") {
+            options.only = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string describe(const Candlestick& candle) {
+    char text[160];
+    std::snprintf(text, sizeof(text), "%s %.17g/%.17g/%.17g/%.17g n=%zu", candle.date.c_str(), candle.open,
+                  candle.high, candle.low, candle.close, candle.count);
+    return text;
+}
+
+/**
+ * Compares two candle series field by field; sums may differ by rounding.
+ *
+ * @return Empty if they match, otherwise the first difference.
+ */
+std::string compareCandles(const std::vector<Candlestick>& expected, const std::vector<Candlestick>& actual) {
+    for (size_t i = 0; i < std::min(expected.size(), actual.size()); ++i) {
+        const Candlestick& e = expected[i];
+        const Candlestick& a = actual[i];
+        bool same = e.date == a.date && e.open == a.open && e.high == a.high && e.low == a.low &&
+                    e.close == a.close && e.count == a.count &&
+                    std::abs(e.sum - a.sum) <= 1e-9 * std::max(1.0, std::abs(e.sum));
+        if (!same) {
+            return "candle " + std::to_string(i) + ": expected " + describe(e) + ", got " + describe(a);
+        }
+    }
+    if (expected.size() != actual.size()) {
+        return "expected " + std::to_string(expected.size()) + " candles, got " + std::to_string(actual.size());
+    }
+    return "";
+}
+
+/**
+ * Random candles with dates in order; lows repeat so the index sees ties.
+ */
+std::vector<Candlestick> randomCandles(std::mt19937_64& random, size_t count) {
+    std::uniform_int_distribution<int> low_step(-60, 80);
+    std::exponential_distribution<double> spread(0.2);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<Candlestick> candles;
+    char date[32];
+    for (size_t i = 0; i < count; ++i) {
+        double low = low_step(random) * 0.5; // Half-degree steps
+        double high = low + (i % 7 == 0 ? 0.0 : spread(random));
+        double open = low + (high - low) * unit(random);
+        double close = low + (high - low) * unit(random);
+        std::snprintf(date, sizeof(date), "d%06zu", i);
+        candles.emplace_back(date, open, high, low, close, 24, (high + low) * 12);
+    }
+    return candles;
+}
+
+/**
+ * Hourly CSV rows for AT and DE from 1995-03-01, without the header. Readings
+ * follow the seasons with noise; about 1% are empty.
+ */
+std::vector<std::string> weatherRows(std::mt19937_64& random, size_t hours) {
+    std::normal_distribution<double> noise(0.0, 3.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const int64_t start = daysFromCivil(1995, 3, 1) * 86400;
+    const double kPi = 3.14159265358979323846;
+
+    std::vector<std::string> rows;
+    char cell[32];
+    for (size_t h = 0; h < hours; ++h) {
+        int64_t timestamp = start + static_cast<int64_t>(h) * 3600;
+        std::string row = formatTimestamp(timestamp);
+        for (double mean : {9.0, 11.0}) {
+            double season = std::sin(2.0 * kPi * static_cast<double>(h) / 8766.0);
+            double warming = static_cast<double>(h) / 8766.0 * 0.03;
+            row += ',';
+            if (unit(random) >= 0.01) {
+                std::snprintf(cell, sizeof(cell), "%.2f", mean + 10.0 * season + warming + noise(random));
+                row += cell;
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+/**
+ * Writes rows under the generator's header to a temporary file.
+ *
+ * @return The file's path; the caller removes it.
+ */
+std::string writeRows(const std::vector<std::string>& rows, const std::string& name) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / ("self_check_" + name + ".csv");
+    std::ofstream out(path);
+    out << "utc_timestamp,AT_temperature,DE_temperature\n";
+    for (const auto& row : rows) {
+        out << row << '\n';
+    }
+    if (!out) {
+        throw std::runtime_error("Could not write " + path.string());
+    }
+    return path.string();
+}
+
+/**
+ * Writes rows to a temporary file and loads them without the binary cache.
+ */
+WeatherTable loadRows(const std::vector<std::string>& rows, const std::string& name) {
+    const std::string path = writeRows(rows, name);
+    LoadOptions load_options;
+    load_options.cache_file.clear();
+    WeatherTable table = loadWeatherTable(path, load_options);
+    std::filesystem::remove(path);
+    return table;
+}
+
+// --- Interval index ---
+
+/**
+ * The index, its filter overload and an indexed CandleView against filterByTemperatureRange and a plain view.
+ */
+std::string checkIntervalIndex(uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> bottom(-40.0, 50.0);
+    std::uniform_real_distribution<double> width(0.0, 20.0);
+    std::uniform_int_distribution<size_t> position(0, 2500);
+
+    for (size_t size : {0, 1, 2, 3, 17, 1000, 2500}) {
+        std::vector<Candlestick> series = randomCandles(random, size);
+        TemperatureIntervalIndex index(series);
+
+        for (int band = 0; band < 300; ++band) {
+            double min_temp = bottom(random);
+            double max_temp = band % 10 == 0 ? min_temp : min_temp + width(random);
+            if (band % 3 == 0) {
+                // On the half-degree grid, so band edges meet candle lows and highs exactly
+                min_temp = std::round(min_temp * 2.0) / 2.0;
+                max_temp = std::round(max_temp * 2.0) / 2.0;
+            }
+            if (band % 25 == 0) {
+                std::swap(min_temp, max_temp); // Inverted bands are empty
+            }
+            std::string where = " (size " + std::to_string(size) + ", band " + std::to_string(min_temp) + " to " +
+                                std::to_string(max_temp) + ")";
+
+            std::vector<Candlestick> expected = filterByTemperatureRange(series, min_temp, max_temp);
+            std::string mismatch = compareCandles(expected, index.query(min_temp, max_temp));
+            if (mismatch.empty()) {
+                mismatch = compareCandles(expected, filterByTemperatureRange(index, min_temp, max_temp));
+            }
+            if (!mismatch.empty()) {
+                return mismatch + where;
+            }
+
+            // Views: a date range on top, and the index attached before or after the band
+            char from[32], to[32];
+            size_t first = position(random), last = first + position(random) / 4;
+            std::snprintf(from, sizeof(from), "d%06zu", first);
+            std::snprintf(to, sizeof(to), "d%06zu", last);
+            CandleView plain(series);
+            plain.temperatureRange(min_temp, max_temp).dateRange(from, to);
+            CandleView indexed(series);
+            if (band % 2 == 0) {
+                indexed.bandIndex(index).temperatureRange(min_temp, max_temp).dateRange(from, to);
+            } else {
+                indexed.temperatureRange(min_temp, max_temp).dateRange(from, to).bandIndex(index);
+            }
+
+            mismatch = compareCandles(plain.materialize(), indexed.materialize());
+            if (mismatch.empty() && plain.count() != indexed.count()) {
+                mismatch = "count " + std::to_string(plain.count()) + " vs " + std::to_string(indexed.count());
+            }
+            if (!mismatch.empty()) {
+                return "view " + mismatch + where + " dates " + from + " to " + to;
+            }
+        }
+    }
+    return "";
+}
+
+// --- Candle rollup ---
+
+/**
+ * Every rollup level against computeCandlestickData, with the rows in order and shuffled.
+ */
+std::string checkRollup(const WeatherTable& table, const WeatherTable& shuffled) {
+    const std::map<std::string, CandleRollup> rollups = buildCandleRollups(table);
+    const CandleRollup sketched(table, "DE", true);
+    const CandleRollup unsorted(shuffled, "AT");
+
+    for (TimeFrame frame : {TimeFrame::Day, TimeFrame::Week, TimeFrame::Month, TimeFrame::Quarter, TimeFrame::Year,
+                            TimeFrame::Decade}) {
+        const std::string name = timeFrameName(frame);
+        for (const std::string country : {"AT", "DE"}) {
+            std::vector<Candlestick> expected = computeCandlestickData(table, country, frame);
+            std::string mismatch = compareCandles(expected, findCandleRollup(rollups, country).candles(frame));
+            if (!mismatch.empty()) {
+                return country + " " + name + " " + mismatch;
+            }
+            if (findCandleRollup(rollups, country).size(frame) != expected.size()) {
+                return country + " " + name + " size differs";
+            }
+        }
+
+        std::string mismatch = compareCandles(computeCandlestickData(table, "DE", frame), sketched.candles(frame));
+        if (!mismatch.empty()) {
+            return "DE " + name + " with quantiles " + mismatch;
+        }
+        mismatch = compareCandles(computeCandlestickData(table, "AT", frame), unsorted.candles(frame));
+        if (!mismatch.empty()) {
+            return "AT " + name + " shuffled " + mismatch;
+        }
+    }
+    return "";
+}
+
+// --- Candle order ---
+
+/**
+ * Every candle builder on shuffled rows against computeCandlestickData on sorted
+ * ones, so open and close follow timestamps everywhere.
+ */
+std::string checkCandleOrder(const WeatherTable& table, const WeatherTable& shuffled,
+                             const std::vector<std::string>& shuffled_rows) {
+    // The legacy builder takes the rows as text cells; rows without an AT reading
+    // are left out, as it would only warn about them
+    std::vector<std::vector<std::string>> cells = {{"utc_timestamp", "AT_temperature", "DE_temperature"}};
+    for (const auto& row : shuffled_rows) {
+        std::vector<std::string> split;
+        std::stringstream line(row);
+        for (std::string cell; std::getline(line, cell, ',');) {
+            split.push_back(cell);
+        }
+        if (split.size() > 1 && !split[1].empty()) {
+            cells.push_back(std::move(split));
+        }
+    }
+
+    for (TimeFrameSpec frame : {TimeFrameSpec(TimeFrame::Hour), TimeFrameSpec(TimeFrame::HourInterval, 6),
+                                TimeFrameSpec(TimeFrame::Day), TimeFrameSpec(TimeFrame::Month)}) {
+        const std::string name = timeFrameName(frame);
+        std::vector<Candlestick> expected = computeCandlestickData(table, "AT", frame);
+
+        std::string mismatch = compareCandles(expected, computeCandlestickData(shuffled, "AT", frame));
+        if (!mismatch.empty()) {
+            return name + " shuffled table " + mismatch;
+        }
+        mismatch = compareCandles(expected, computeCandlestickData(cells, "AT", name));
+        if (!mismatch.empty()) {
+            return name + " shuffled text " + mismatch;
+        }
+
+        ColumnAggregates aggregates = aggregateColumns(shuffled, frame, {"AT_temperature"});
+        std::vector<Candlestick> aggregated;
+        for (size_t b = 0; b < aggregates.bucketCount(); ++b) {
+            if (aggregates.count[aggregates.index(0, b)] > 0) {
+                aggregated.push_back(aggregates.candle(0, b));
+            }
+        }
+        mismatch = compareCandles(expected, aggregated);
+        if (!mismatch.empty()) {
+            return name + " shuffled aggregate " + mismatch;
+        }
+    }
+    return "";
+}
+
+// --- Column aggregation ---
+
+/**
+ * aggregateColumns on shuffled rows, whose buckets arrive in many runs, against
+ * a per-bucket count, sum, mean and two-pass variance.
+ */
+std::string checkAggregation(const WeatherTable& shuffled) {
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    auto close = [](double expected, double actual, double tolerance) {
+        return std::abs(expected - actual) <= tolerance * std::max(1.0, std::abs(expected));
+    };
+
+    for (TimeFrameSpec frame : {TimeFrameSpec(TimeFrame::HourInterval, 6), TimeFrameSpec(TimeFrame::Day),
+                                TimeFrameSpec(TimeFrame::Month), TimeFrameSpec(TimeFrame::Year)}) {
+        const std::string name = timeFrameName(frame);
+        ColumnAggregates aggregates = aggregateColumns(shuffled, frame, {"AT_temperature", "DE_temperature"});
+
+        for (size_t c = 0; c < aggregates.columnCount(); ++c) {
+            const std::vector<double>& column = shuffled.columns[shuffled.findColumn(aggregates.column_names[c])];
+            std::map<int64_t, std::vector<double>> buckets;
+            for (size_t row = 0; row < column.size(); ++row) {
+                std::vector<double>& readings = buckets[timeBucketId(shuffled.timestamps[row], frame)];
+                if (!std::isnan(column[row])) {
+                    readings.push_back(column[row]);
+                }
+            }
+            if (buckets.size() != aggregates.bucketCount()) {
+                return name + " has " + std::to_string(aggregates.bucketCount()) + " buckets, expected " +
+                       std::to_string(buckets.size());
+            }
+
+            size_t b = 0;
+            for (const auto& [id, readings] : buckets) {
+                double sum = 0.0;
+                for (double value : readings) {
+                    sum += value;
+                }
+                const double n = static_cast<double>(readings.size());
+                const double mean = readings.empty() ? missing : sum / n;
+                double squares = 0.0;
+                for (double value : readings) {
+                    squares += (value - mean) * (value - mean);
+                }
+                const double variance = readings.size() < 2 ? missing : squares / (n - 1.0);
+
+                const size_t slot = aggregates.index(c, b);
+                const double actual_variance = aggregates.variance(c, b);
+                bool same = aggregates.bucket_ids[b] == id && aggregates.count[slot] == readings.size();
+                if (same && readings.empty()) {
+                    same = std::isnan(aggregates.sum[slot]) && std::isnan(aggregates.mean[slot]);
+                } else if (same) {
+                    same = close(sum, aggregates.sum[slot], 1e-9) && close(mean, aggregates.mean[slot], 1e-9) &&
+                           std::isnan(variance) == std::isnan(actual_variance) &&
+                           (std::isnan(variance) || close(variance, actual_variance, 1e-9));
+                }
+                if (!same) {
+                    char text[200];
+                    std::snprintf(text, sizeof(text),
+                                  "%s %s bucket %zu: n=%llu sum %.17g mean %.17g var %.17g, expected n=%zu "
+                                  "%.17g %.17g %.17g",
+                                  name.c_str(), aggregates.column_names[c].c_str(), b,
+                                  static_cast<unsigned long long>(aggregates.count[slot]), aggregates.sum[slot],
+                                  aggregates.mean[slot], actual_variance, readings.size(), sum, mean, variance);
+                    return text;
+                }
+                ++b;
+            }
+        }
+    }
+    return "";
+}
+
+// --- Indicators ---
+
+/**
+ * Every indicator series recomputed from its window alone: SMA, seeded EMA,
+ * Bollinger bands with the population deviation, Wilder's ATR and Donchian extremes.
+ */
+std::map<std::string, std::vector<double>> naiveIndicators(const std::vector<IndicatorSpec>& specs,
+                                                           const std::vector<Candlestick>& candles) {
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    const size_t n = candles.size();
+    std::map<std::string, std::vector<double>> result;
+    for (const auto& spec : specs) {
+        const std::string name = indicatorName(spec);
+        const size_t p = spec.period;
+        auto window_mean = [&](size_t last) {
+            double sum = 0.0;
+            for (size_t k = last + 1 - p; k <= last; ++k) {
+                sum += candles[k].close;
+            }
+            return sum / static_cast<double>(p);
+        };
+
+        switch (spec.kind) {
+            case IndicatorKind::Sma: {
+                std::vector<double>& sma = result[name];
+                for (size_t i = 0; i < n; ++i) {
+                    sma.push_back(i + 1 < p ? missing : window_mean(i));
+                }
+                break;
+            }
+            case IndicatorKind::Ema: {
+                std::vector<double>& ema = result[name];
+                const double alpha = 2.0 / (static_cast<double>(p) + 1.0);
+                for (size_t i = 0; i < n; ++i) {
+                    if (i + 1 < p) {
+                        ema.push_back(missing);
+                    } else if (i + 1 == p) {
+                        ema.push_back(window_mean(i));
+                    } else {
+                        ema.push_back(ema.back() + alpha * (candles[i].close - ema.back()));
+                    }
+                }
+                break;
+            }
+            case IndicatorKind::Bollinger: {
+                std::vector<double>& middle = result[name + "_middle"];
+                std::vector<double>& upper = result[name + "_upper"];
+                std::vector<double>& lower = result[name + "_lower"];
+                for (size_t i = 0; i < n; ++i) {
+                    if (i + 1 < p) {
+                        middle.push_back(missing);
+                        upper.push_back(missing);
+                        lower.push_back(missing);
+                        continue;
+                    }
+                    double mean = window_mean(i);
+                    double squares = 0.0;
+                    for (size_t k = i + 1 - p; k <= i; ++k) {
+                        squares += (candles[k].close - mean) * (candles[k].close - mean);
+                    }
+                    double spread = 2.0 * std::sqrt(squares / static_cast<double>(p));
+                    middle.push_back(mean);
+                    upper.push_back(mean + spread);
+                    lower.push_back(mean - spread);
+                }
+                break;
+            }
+            case IndicatorKind::Atr: {
+                std::vector<double> true_ranges;
+                for (size_t i = 0; i < n; ++i) {
+                    double range = candles[i].high - candles[i].low;
+                    if (i > 0) {
+                        range = std::max({range, std::abs(candles[i].high - candles[i - 1].close),
+                                          std::abs(candles[i].low - candles[i - 1].close)});
+                    }
+                    true_ranges.push_back(range);
+                }
+                std::vector<double>& atr = result[name];
+                for (size_t i = 0; i < n; ++i) {
+                    if (i + 1 < p) {
+                        atr.push_back(missing);
+                    } else if (i + 1 == p) {
+                        double sum = 0.0;
+                        for (size_t k = 0; k < p; ++k) {
+                            sum += true_ranges[k];
+                        }
+                        atr.push_back(sum / static_cast<double>(p));
+                    } else {
+                        atr.push_back((atr.back() * (static_cast<double>(p) - 1.0) + true_ranges[i]) /
+                                      static_cast<double>(p));
+                    }
+                }
+                break;
+            }
+            case IndicatorKind::Donchian: {
+                std::vector<double>& high = result[name + "_high"];
+                std::vector<double>& low = result[name + "_low"];
+                for (size_t i = 0; i < n; ++i) {
+                    if (i + 1 < p) {
+                        high.push_back(missing);
+                        low.push_back(missing);
+                        continue;
+                    }
+                    double highest = candles[i].high, lowest = candles[i].low;
+                    for (size_t k = i + 1 - p; k <= i; ++k) {
+                        highest = std::max(highest, candles[k].high);
+                        lowest = std::min(lowest, candles[k].low);
+                    }
+                    high.push_back(highest);
+                    low.push_back(lowest);
+                }
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * CandleIndicators against naiveIndicators on random and daily candles, built
+ * whole, appended candle by candle, and resumed halfway with append.
+ */
+std::string checkIndicators(const WeatherTable& table, uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<IndicatorSpec> specs;
+    for (const char* text : {"sma1", "sma5", "ema1", "ema12", "bb2", "bb20", "atr1", "atr14", "donchian1",
+                             "donchian30", "donchian365"}) {
+        specs.push_back(parseIndicator(text));
+    }
+
+    const std::vector<Candlestick> daily = computeCandlestickData(table, "DE", TimeFrame::Day);
+    const std::vector<Candlestick> random_candles = randomCandles(random, 900);
+    for (const std::vector<Candlestick>* candles : {&daily, &random_candles}) {
+        const std::string source = candles == &daily ? "daily " : "random ";
+        std::map<std::string, std::vector<double>> expected = naiveIndicators(specs, *candles);
+
+        CandleIndicators whole(specs, *candles);
+        CandleIndicators appended(specs);
+        const size_t half = candles->size() * 2 / 5;
+        CandleIndicators resumed(specs, {candles->begin(), candles->begin() + half});
+        for (size_t i = 0; i < candles->size(); ++i) {
+            appended.append((*candles)[i]);
+            if (i >= half) {
+                resumed.append((*candles)[i]);
+            }
+        }
+        if (whole.seriesCount() != expected.size() || whole.size() != candles->size() ||
+            appended.size() != candles->size() || resumed.size() != candles->size()) {
+            return source + "series or candle counts differ";
+        }
+
+        std::map<std::string, size_t> positions;
+        for (size_t series = 0; series < whole.seriesCount(); ++series) {
+            positions[whole.seriesName(series)] = series;
+        }
+        for (size_t series = 0; series < whole.seriesCount(); ++series) {
+            const std::string& name = whole.seriesName(series);
+            auto it = expected.find(name);
+            if (it == expected.end()) {
+                return source + "unexpected series " + name;
+            }
+
+            // A band's offset is a square root, so near-constant windows are compared by variance
+            const std::string suffix = name.substr(name.find('_') + 1);
+            const bool band = suffix == "upper" || suffix == "lower";
+            const std::string middle = name.substr(0, name.find('_')) + "_middle";
+            for (size_t i = 0; i < candles->size(); ++i) {
+                double e = it->second[i];
+                double a = whole.series(series)[i];
+                bool same = std::isnan(e) ? std::isnan(a) : std::abs(a - e) <= 1e-9 * std::max(1.0, std::abs(e));
+                if (band && !same && !std::isnan(e) && !std::isnan(a)) {
+                    double expected_offset = (e - expected[middle][i]) / 2.0;
+                    double offset = (a - whole.series(positions[middle])[i]) / 2.0;
+                    double mean = expected[middle][i];
+                    same = std::abs(offset * offset - expected_offset * expected_offset) <=
+                           1e-9 * std::max(1.0, mean * mean);
+                }
+                if (!same) {
+                    char text[160];
+                    std::snprintf(text, sizeof(text), "%s%s candle %zu: %.17g, expected %.17g", source.c_str(),
+                                  name.c_str(), i, a, e);
+                    return text;
+                }
+                for (const CandleIndicators* incremental : {&appended, &resumed}) {
+                    double b = incremental->series(series)[i];
+                    if (!(b == a || (std::isnan(a) && std::isnan(b)))) {
+                        return source + name + " candle " + std::to_string(i) +
+                               (incremental == &appended ? " appended" : " resumed") + " differs from a whole build";
+                    }
+                }
+            }
+        }
+    }
+    return "";
+}
+
+// --- Polynomial fitting ---
+
+/**
+ * fitPolynomial on samples of exact polynomials, including too many and too few coefficients.
+ */
+std::string checkPolynomialFit(uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> coefficient(-5.0, 5.0);
+    std::uniform_int_distribution<int> gap(1, 3);
+    char text[160];
+
+    for (int degree = 0; degree <= 5; ++degree) {
+        // p(x) = sum c_k ((x - 1990) / 40)^k, sampled on uneven years
+        std::vector<double> c(static_cast<size_t>(degree) + 1);
+        for (auto& value : c) {
+            value = coefficient(random);
+        }
+        auto p = [&c](double x) {
+            double t = (x - 1990.0) / 40.0, y = 0.0;
+            for (size_t k = c.size(); k-- > 0;) {
+                y = y * t + c[k];
+            }
+            return y;
+        };
+        std::vector<double> x, y;
+        for (int year = 1950; year <= 2030; year += gap(random)) {
+            x.push_back(year);
+            y.push_back(p(year));
+        }
+
+        for (int fit_degree : {degree, degree + 2}) {
+            PolynomialFit fit = fitPolynomial(x, y, fit_degree);
+            if (fit.rank != static_cast<size_t>(fit_degree) + 1 || fit.samples != x.size() || fit.rms_error > 1e-9) {
+                std::snprintf(text, sizeof(text), "degree %d data, degree %d fit: rank %zu, samples %zu, rms %.3g",
+                              degree, fit_degree, fit.rank, fit.samples, fit.rms_error);
+                return text;
+            }
+            // Within the samples and a few years past them, as forecasts use it
+            for (double year = 1950.0; year <= 2035.0; year += 0.5) {
+                if (std::abs(fit.evaluate(year) - p(year)) > 1e-8) {
+                    std::snprintf(text, sizeof(text), "degree %d data, degree %d fit: %.17g at %g, expected %.17g",
+                                  degree, fit_degree, fit.evaluate(year), year, p(year));
+                    return text;
+                }
+            }
+        }
+    }
+
+    // Rank-deficient inputs: fewer samples than coefficients, and repeated x
+    PolynomialFit few = fitPolynomial({2000, 2001, 2003}, {1.0, -2.0, 4.0}, 4);
+    if (few.rank != 3 || std::abs(few.evaluate(2001) + 2.0) > 1e-9 || std::abs(few.evaluate(2003) - 4.0) > 1e-9) {
+        return "three samples, degree 4: rank " + std::to_string(few.rank);
+    }
+    PolynomialFit repeated = fitPolynomial({2000, 2000, 2000}, {5.0, 5.0, 5.0}, 2);
+    if (repeated.rank != 1 || std::abs(repeated.evaluate(2000) - 5.0) > 1e-12) {
+        return "repeated x: rank " + std::to_string(repeated.rank);
+    }
+    if (fitPolynomial({}, {}, 2).rank != 0) {
+        return "no samples: nonzero rank";
+    }
+    return "";
+}
+
+/**
+ * runRegressionBatch on several threads against one thread and against fitting each job directly.
+ */
+std::string checkRegressionBatch(const WeatherTable& table) {
+    std::vector<RegressionJob> jobs;
+    for (const std::string country : {"AT", "DE", "XX"}) {
+        for (int span : {3, 6, 11}) {
+            for (int degree = 1; degree <= 3; ++degree) {
+                jobs.push_back({country, 2006 - span, 2005, degree, 3});
+            }
+        }
+    }
+
+    std::vector<RegressionResult> serial = runRegressionBatch(table, jobs, 1);
+    std::vector<RegressionResult> parallel = runRegressionBatch(table, jobs, 4);
+    if (serial.size() != jobs.size() || parallel.size() != jobs.size()) {
+        return "wrong number of results";
+    }
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const RegressionJob& job = jobs[i];
+        const std::string where = " for job " + job.country_prefix + " " + std::to_string(job.start_year) + "-" +
+                                  std::to_string(job.end_year) + " degree " + std::to_string(job.degree);
+        if (job.country_prefix == "XX") {
+            if (serial[i].error.empty() || parallel[i].error.empty()) {
+                return "no error" + where;
+            }
+            continue;
+        }
+        if (!serial[i].error.empty() || serial[i].predictions != parallel[i].predictions) {
+            return "threads disagree" + where;
+        }
+
+        std::vector<double> x, y;
+        for (const auto& candle : computeCandlestickData(table, job.country_prefix, TimeFrame::Year)) {
+            int year = std::stoi(candle.date);
+            if (year >= job.start_year && year <= job.end_year) {
+                x.push_back(year);
+                y.push_back((candle.high + candle.low) / 2);
+            }
+        }
+        PolynomialFit fit = fitPolynomial(x, y, job.degree);
+        if (serial[i].values != y || serial[i].predict_years.size() != 3) {
+            return "yearly values differ" + where;
+        }
+        for (size_t h = 0; h < 3; ++h) {
+            if (serial[i].predict_years[h] != static_cast<int>(x.back()) + static_cast<int>(h) + 1 ||
+                serial[i].predictions[h] != fit.evaluate(serial[i].predict_years[h])) {
+                return "prediction " + std::to_string(h) + " differs" + where;
+            }
+        }
+    }
+    return "";
+}
+
+// --- Online forecaster ---
+
+std::string savedState(const OnlineForecaster& forecaster) {
+    std::ostringstream out;
+    forecaster.save(out);
+    return out.str();
+}
+
+/**
+ * Online fits against fitPolynomial on the yearly candles, saved state round
+ * trips, resuming a half-table state on the whole table, and rebuilding from
+ * shuffled or shrunk input.
+ */
+std::string checkForecaster(const WeatherTable& table, const WeatherTable& shuffled, const WeatherTable& first_half) {
+    char text[160];
+    for (int degree = 1; degree <= 3; ++degree) {
+        std::map<std::string, OnlineForecaster> forecasters = buildOnlineForecasters(table, degree);
+        for (const std::string country : {"AT", "DE"}) {
+            std::vector<double> x, y;
+            std::vector<int> years;
+            for (const auto& candle : computeCandlestickData(table, country, TimeFrame::Year)) {
+                years.push_back(std::stoi(candle.date));
+                x.push_back(years.back());
+                y.push_back((candle.high + candle.low) / 2);
+            }
+
+            const OnlineForecaster& forecaster = forecasters.at(country);
+            if (!forecaster.covers(years) || forecaster.covers({years.begin() + 1, years.end()})) {
+                return country + " covers the wrong years";
+            }
+            PolynomialFit fit = fitPolynomial(x, y, degree);
+            std::vector<int> predict_years = {years.front(), years.back(), years.back() + 1, years.back() + 3};
+            std::vector<double> predictions = forecaster.predict(predict_years);
+            for (size_t i = 0; i < predict_years.size(); ++i) {
+                if (std::abs(predictions[i] - fit.evaluate(predict_years[i])) > 1e-7) {
+                    std::snprintf(text, sizeof(text), "%s degree %d: %.17g for %d, batch fit %.17g",
+                                  country.c_str(), degree, predictions[i], predict_years[i],
+                                  fit.evaluate(predict_years[i]));
+                    return text;
+                }
+            }
+
+            // The text record restores the exact state
+            std::istringstream in(savedState(forecaster));
+            OnlineForecaster restored;
+            if (!restored.restore(in) || savedState(restored) != savedState(forecaster) ||
+                restored.predict(predict_years) != predictions) {
+                return country + " degree " + std::to_string(degree) + " does not survive save and restore";
+            }
+        }
+    }
+
+    // Files: save, load, then bring a half-table state up to date
+    std::map<std::string, OnlineForecaster> expected = buildOnlineForecasters(table, 2);
+    std::map<std::string, OnlineForecaster> half = buildOnlineForecasters(first_half, 2);
+    const std::string path = (std::filesystem::temp_directory_path() / "self_check_forecasts.txt").string();
+    std::map<std::string, OnlineForecaster> loaded;
+    bool round_trip = saveForecasters(half, path) && loadForecasters(path, loaded);
+    std::filesystem::remove(path);
+    if (!round_trip || loaded.size() != half.size()) {
+        return "saveForecasters and loadForecasters lose the state";
+    }
+
+    for (const std::string country : {"AT", "DE"}) {
+        if (savedState(loaded.at(country)) != savedState(half.at(country))) {
+            return country + " differs after loadForecasters";
+        }
+        updateForecaster(loaded, table, country, 2);
+        if (savedState(loaded.at(country)) != savedState(expected.at(country))) {
+            return country + " resumed from half the rows differs from a full build";
+        }
+        updateForecaster(loaded, table, country, 2);
+        if (savedState(loaded.at(country)) != savedState(expected.at(country))) {
+            return country + " changes when updated twice";
+        }
+    }
+
+    // Out-of-order readings make a forecaster stale; updateForecaster rebuilds it
+    std::map<std::string, OnlineForecaster> from_shuffled = buildOnlineForecasters(shuffled, 2);
+    for (const std::string country : {"AT", "DE"}) {
+        const std::vector<double>& column = shuffled.temperatureColumn(country);
+        OnlineForecaster direct(2);
+        size_t rejected = 0;
+        for (size_t row = 0; row < column.size(); ++row) {
+            rejected += direct.addReading(shuffled.timestamps[row], column[row]) ? 0 : 1;
+        }
+        std::vector<int> years;
+        for (int year = direct.openYear() - 10; year <= direct.openYear(); ++year) {
+            years.push_back(year);
+        }
+        if (rejected == 0 || !direct.stale() || direct.covers(years)) {
+            return country + " fed shuffled rows is not marked stale";
+        }
+        if (savedState(from_shuffled.at(country)) != savedState(expected.at(country))) {
+            return country + " built from shuffled rows differs from a build in order";
+        }
+
+        // A state that has seen rows the table no longer holds is rebuilt too
+        std::map<std::string, OnlineForecaster> shrunk = expected;
+        updateForecaster(shrunk, first_half, country, 2);
+        if (savedState(shrunk.at(country)) != savedState(half.at(country))) {
+            return country + " updated with fewer rows differs from a build on them";
+        }
+    }
+    return "";
+}
+
+// --- Quantile sketch ---
+
+/**
+ * How far q lies from the ranks an estimate occupies in the sorted readings.
+ */
+double rankError(const std::vector<double>& sorted, double estimate, double q) {
+    const double n = static_cast<double>(sorted.size());
+    double lower = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / n;
+    double upper = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / n;
+    return q < lower ? lower - q : (q > upper ? q - upper : 0.0);
+}
+
+/**
+ * Sketched quantiles against exact ranks: one sketch, merged sketches, small
+ * inputs and the rollup's per-month sketches.
+ */
+std::string checkQuantileSketch(const WeatherTable& table, uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::normal_distribution<double> normal(10.0, 8.0);
+    std::exponential_distribution<double> tail(0.5);
+    const std::vector<double> probabilities = {0.0, 0.001, 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99, 0.999, 1.0};
+    char text[160];
+
+    // A skewed mix, sketched whole and as twenty uneven merged parts, so some input is still buffered
+    std::vector<double> values;
+    QuantileSketch whole;
+    std::vector<QuantileSketch> parts(20);
+    std::uniform_int_distribution<size_t> part(0, parts.size() - 1);
+    for (size_t i = 0; i < 200000; ++i) {
+        values.push_back(i % 4 == 0 ? 20.0 + tail(random) : normal(random));
+        whole.add(values.back());
+        parts[part(random)].add(values.back());
+    }
+    QuantileSketch merged;
+    for (const auto& part : parts) {
+        merged.merge(part);
+    }
+    std::sort(values.begin(), values.end());
+    whole.compress();
+    merged.compress();
+
+    for (const QuantileSketch* sketch : {&whole, &merged}) {
+        const char* name = sketch == &whole ? "whole" : "merged";
+        if (sketch->count() != values.size() || sketch->min() != values.front() || sketch->max() != values.back()) {
+            return std::string(name) + " sketch lost the count, minimum or maximum";
+        }
+        for (double q : probabilities) {
+            double error = rankError(values, sketch->quantile(q), q);
+            if (error > 0.01) {
+                std::snprintf(text, sizeof(text), "%s sketch: rank error %.4f at q=%g", name, error, q);
+                return text;
+            }
+        }
+    }
+
+    // A day of readings is kept exactly
+    std::vector<double> day(values.begin(), values.begin() + 24);
+    QuantileSketch small;
+    for (double value : day) {
+        small.add(value);
+    }
+    for (double q : probabilities) {
+        if (rankError(day, small.quantile(q), q) > 1.0 / 24.0) {
+            std::snprintf(text, sizeof(text), "24 readings: %.17g at q=%g", small.quantile(q), q);
+            return text;
+        }
+    }
+
+    // The rollup's month sketches are merged from day sketches of ~24 readings, so allow twice the error
+    const std::vector<double>& temps = table.temperatureColumn("DE");
+    std::map<std::string, std::vector<double>> months;
+    char month[16];
+    for (size_t i = 0; i < table.rowCount(); ++i) {
+        if (!std::isnan(temps[i])) {
+            CivilTime civil = civilFromEpoch(table.timestamps[i]);
+            std::snprintf(month, sizeof(month), "%04d-%02d", civil.year, civil.month);
+            months[month].push_back(temps[i]);
+        }
+    }
+    CandleQuantiles quantiles = CandleRollup(table, "DE", true).quantiles(TimeFrame::Month, {0.05, 0.5, 0.95});
+    if (quantiles.dates.size() != months.size()) {
+        return "rollup has " + std::to_string(quantiles.dates.size()) + " months, expected " +
+               std::to_string(months.size());
+    }
+    for (size_t m = 0; m < quantiles.dates.size(); ++m) {
+        std::vector<double>& readings = months[quantiles.dates[m]];
+        std::sort(readings.begin(), readings.end());
+        for (size_t p = 0; p < quantiles.probabilities.size(); ++p) {
+            double error = rankError(readings, quantiles.value(m, p), quantiles.probabilities[p]);
+            if (readings.empty() || error > 0.02) {
+                std::snprintf(text, sizeof(text), "rollup %s: rank error %.4f at q=%g", quantiles.dates[m].c_str(),
+                              error, quantiles.probabilities[p]);
+                return text;
+            }
+        }
+    }
+    return "";
+}
+
+// --- Range index ---
+
+/**
+ * Range queries against a scan of every row, on the table in order and shuffled.
+ */
+std::string checkRangeIndex(const WeatherTable& table, const WeatherTable& shuffled, uint64_t seed) {
+    std::mt19937_64 random(seed);
+    const int64_t first = table.timestamps.front();
+    const int64_t last = table.timestamps.back();
+    std::uniform_int_distribution<int64_t> start(first - 86400, last + 86400);
+    std::uniform_int_distribution<int64_t> length(-3600, 400 * 86400);
+
+    for (const WeatherTable* source : {&table, &shuffled}) {
+        for (const std::string country : {"AT", "DE"}) {
+            const std::vector<double>& column = source->temperatureColumn(country);
+            RangeQueryIndex index(*source, country);
+            for (int query = 0; query < 200; ++query) {
+                int64_t start_time = query == 0 ? first : start(random);
+                int64_t end_time = query == 0 ? last : start_time + length(random);
+
+                RangeSummary expected;
+                for (size_t row = 0; row < column.size(); ++row) {
+                    int64_t time = source->timestamps[row];
+                    double value = column[row];
+                    if (time < start_time || time > end_time || std::isnan(value)) {
+                        continue;
+                    }
+                    if (expected.count == 0 || time < expected.open_time) {
+                        expected.open = value;
+                        expected.open_time = time;
+                    }
+                    if (expected.count == 0 || time >= expected.close_time) {
+                        expected.close = value;
+                        expected.close_time = time;
+                    }
+                    expected.high = expected.count == 0 ? value : std::max(expected.high, value);
+                    expected.low = expected.count == 0 ? value : std::min(expected.low, value);
+                    ++expected.count;
+                }
+
+                RangeSummary actual = index.query(start_time, end_time);
+                bool same = actual.count == expected.count;
+                if (same && !expected.empty()) {
+                    same = actual.open == expected.open && actual.high == expected.high &&
+                           actual.low == expected.low && actual.close == expected.close &&
+                           actual.open_time == expected.open_time && actual.close_time == expected.close_time;
+                }
+                if (!same) {
+                    return std::string(source == &table ? "" : "shuffled ") + country + " [" +
+                           std::to_string(start_time) + ", " + std::to_string(end_time) + "] differs from a scan";
+                }
+            }
+        }
+    }
+    return "";
+}
+
+// --- Correlation ---
+
+/**
+ * correlateColumns against a two-pass Pearson correlation and covariance over
+ * the paired rows. Seven columns leave the last tile short; they have scattered
+ * and long gaps, a constant series, a nearly empty one and a large offset.
+ */
+std::string checkCorrelation(uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const size_t rows = 5000;
+    const size_t count = 7;
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<std::vector<double>> columns(count, std::vector<double>(rows));
+    for (size_t row = 0; row < rows; ++row) {
+        double base = normal(random);
+        columns[0][row] = base;
+        columns[1][row] = unit(random) < 0.1 ? missing : 0.6 * base + 0.8 * normal(random);
+        columns[2][row] = row >= 1200 && row < 3300 ? missing : normal(random) * 5.0 + 20.0;
+        columns[3][row] = unit(random) < 0.3 ? missing : 2.5;
+        columns[4][row] = row == 4321 ? 1.0 : missing;
+        columns[5][row] = unit(random) < 0.05 ? missing : -2.0 * base + 0.1 * normal(random);
+        columns[6][row] = 1.0e4 + 0.01 * normal(random) + 0.001 * base;
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "self_check_correlation.csv").string();
+    std::vector<std::string> names;
+    {
+        std::ofstream out(path);
+        out << "utc_timestamp";
+        for (size_t c = 0; c < count; ++c) {
+            names.push_back("C" + std::to_string(c) + "_value");
+            out << ',' << names.back();
+        }
+        out << '\n';
+        char cell[32];
+        for (size_t row = 0; row < rows; ++row) {
+            out << formatTimestamp(daysFromCivil(2001, 1, 1) * 86400 + static_cast<int64_t>(row) * 3600);
+            for (size_t c = 0; c < count; ++c) {
+                out << ',';
+                if (!std::isnan(columns[c][row])) {
+                    std::snprintf(cell, sizeof(cell), "%.17g", columns[c][row]);
+                    out << cell;
+                }
+            }
+            out << '\n';
+        }
+    }
+    LoadOptions load_options;
+    load_options.cache_file.clear();
+    const WeatherTable table = loadWeatherTable(path, load_options);
+    std::filesystem::remove(path);
+
+    char text[200];
+    for (unsigned threads : {1u, 3u}) {
+        CorrelationMatrix matrix = correlateColumns(table, names, threads);
+        if (matrix.size() != count) {
+            return std::to_string(matrix.size()) + " columns, expected " + std::to_string(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < count; ++j) {
+                // Two passes over the rows where both columns hold a reading
+                const std::vector<double>& x = columns[i];
+                const std::vector<double>& y = columns[j];
+                double n = 0.0, sum_x = 0.0, sum_y = 0.0;
+                for (size_t row = 0; row < rows; ++row) {
+                    if (!std::isnan(x[row]) && !std::isnan(y[row])) {
+                        n += 1.0;
+                        sum_x += x[row];
+                        sum_y += y[row];
+                    }
+                }
+                double sxy = 0.0, sxx = 0.0, syy = 0.0;
+                for (size_t row = 0; row < rows; ++row) {
+                    if (!std::isnan(x[row]) && !std::isnan(y[row])) {
+                        double dx = x[row] - sum_x / n;
+                        double dy = y[row] - sum_y / n;
+                        sxy += dx * dy;
+                        sxx += dx * dx;
+                        syy += dy * dy;
+                    }
+                }
+                double covariance = n >= 2 ? sxy / (n - 1.0) : missing;
+                double correlation = n >= 2 && sxx > 0.0 && syy > 0.0 ? sxy / std::sqrt(sxx * syy) : missing;
+
+                const size_t slot = matrix.index(i, j);
+                double scale = std::sqrt(sxx * syy) / std::max(n - 1.0, 1.0);
+                bool same = matrix.pairs[slot] == static_cast<uint64_t>(n) &&
+                            std::isnan(matrix.covariance[slot]) == std::isnan(covariance) &&
+                            std::isnan(matrix.correlation[slot]) == std::isnan(correlation) &&
+                            (std::isnan(covariance) ||
+                             std::abs(matrix.covariance[slot] - covariance) <= 1e-9 * std::max(scale, 1e-12)) &&
+                            (std::isnan(correlation) || std::abs(matrix.correlation[slot] - correlation) <= 1e-9);
+                if (!same) {
+                    std::snprintf(text, sizeof(text),
+                                  "%u threads, %s x %s: r %.17g cov %.17g pairs %llu, expected %.17g %.17g %.0f",
+                                  threads, names[i].c_str(), names[j].c_str(), matrix.correlation[slot],
+                                  matrix.covariance[slot], static_cast<unsigned long long>(matrix.pairs[slot]),
+                                  correlation, covariance, n);
+                    return text;
+                }
+            }
+        }
+    }
+    return "";
+}
+
+// --- Threaded load ---
+
+/**
+ * A shuffled file loaded on one thread and on several must give the same table, row for row.
+ */
+std::string checkThreadedLoad(const std::vector<std::string>& shuffled_rows) {
+    const std::string path = writeRows(shuffled_rows, "threads");
+    LoadOptions load_options;
+    load_options.cache_file.clear();
+    load_options.threads = 1;
+    const WeatherTable single = loadWeatherTable(path, load_options);
+
+    for (unsigned threads : {2u, 4u, 7u}) {
+        load_options.threads = threads;
+        const WeatherTable parallel = loadWeatherTable(path, load_options);
+        const std::string label = std::to_string(threads) + " threads: ";
+        if (parallel.column_names != single.column_names || parallel.timestamps != single.timestamps) {
+            std::filesystem::remove(path);
+            return label + "timestamps or columns differ";
+        }
+        for (size_t c = 0; c < single.columns.size(); ++c) {
+            for (size_t i = 0; i < single.rowCount(); ++i) {
+                double a = single.columns[c][i];
+                double b = parallel.columns[c][i];
+                if (!(a == b || (std::isnan(a) && std::isnan(b)))) {
+                    std::filesystem::remove(path);
+                    return label + single.column_names[c] + " row " + std::to_string(i) + " differs";
+                }
+            }
+        }
+    }
+    std::filesystem::remove(path);
+    return "";
+}
+
+// --- Streaming ---
+
+/**
+ * CsvStreamReader with small windows against CsvReader, and streamed candles against the table's.
+ */
+std::string checkStreaming(const std::vector<std::string>& rows, const WeatherTable& table) {
+    // CRLF and LF endings, blank lines, lines longer than the window and no final newline
+    const std::string path = (std::filesystem::temp_directory_path() / "self_check_lines.csv").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "a,b,c\r\n\n1,,3\n" << std::string(300, 'x') << ",y\r\n\r\n,\n" << std::string(150, 'z') << ",,last";
+    }
+    std::vector<std::vector<std::string>> expected;
+    CsvReader mapped(path);
+    mapped.forEachRow([&expected](size_t, const std::vector<std::string_view>& cells) {
+        expected.emplace_back(cells.begin(), cells.end());
+    });
+
+    for (size_t window : {64, 100, 1 << 20}) {
+        CsvStreamReader streamed(path, ',', window);
+        std::vector<std::string_view> cells;
+        size_t row = 0;
+        for (; streamed.nextRow(cells); ++row) {
+            if (row >= expected.size() || std::vector<std::string>(cells.begin(), cells.end()) != expected[row]) {
+                std::filesystem::remove(path);
+                return "window " + std::to_string(window) + ": row " + std::to_string(row) + " differs";
+            }
+        }
+        if (row != expected.size()) {
+            std::filesystem::remove(path);
+            return "window " + std::to_string(window) + ": " + std::to_string(row) + " rows, expected " +
+                   std::to_string(expected.size());
+        }
+    }
+    std::filesystem::remove(path);
+
+    const std::string weather = writeRows(rows, "stream");
+    for (TimeFrameSpec frame : {TimeFrameSpec(TimeFrame::Year), TimeFrameSpec(TimeFrame::Day),
+                                TimeFrameSpec(TimeFrame::HourInterval, 6)}) {
+        std::vector<Candlestick> streamed;
+        streamCandlestickData(weather, "AT", frame, [&streamed](const Candlestick& candle) {
+            streamed.push_back(candle);
+        });
+        std::string mismatch = compareCandles(computeCandlestickData(table, "AT", frame), streamed);
+        if (!mismatch.empty()) {
+            std::filesystem::remove(weather);
+            return timeFrameName(frame) + " " + mismatch;
+        }
+    }
+    std::filesystem::remove(weather);
+    return "";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s [--seed N] [--only SUBSTRING]\n", argv[0]);
+        return 1;
+    }
+
+    Checker checker(options);
+
+    checker.check("interval_index", [&]() { return checkIntervalIndex(options.seed); });
+    checker.check("polynomial_fit", [&]() { return checkPolynomialFit(options.seed); });
+
+    // Eleven years of hourly rows, and the same rows shuffled
+    std::mt19937_64 random(options.seed);
+    std::vector<std::string> rows = weatherRows(random, 11 * 8766);
+    std::vector<std::string> shuffled_rows = rows;
+    std::shuffle(shuffled_rows.begin(), shuffled_rows.end(), random);
+    const WeatherTable table = loadRows(rows, "sorted");
+    const WeatherTable shuffled = loadRows(shuffled_rows, "shuffled");
+    const WeatherTable first_half = loadRows({rows.begin(), rows.begin() + rows.size() / 2}, "half");
+
+    checker.check("rollup", [&]() { return checkRollup(table, shuffled); });
+    checker.check("candle_order", [&]() { return checkCandleOrder(table, shuffled, shuffled_rows); });
+    checker.check("aggregation", [&]() { return checkAggregation(shuffled); });
+    checker.check("indicators", [&]() { return checkIndicators(table, options.seed); });
+    checker.check("regression_batch", [&]() { return checkRegressionBatch(table); });
+    checker.check("online_forecaster", [&]() { return checkForecaster(table, shuffled, first_half); });
+    checker.check("quantile_sketch", [&]() { return checkQuantileSketch(table, options.seed); });
+    checker.check("correlation", [&]() { return checkCorrelation(options.seed); });
+    checker.check("range_index", [&]() { return checkRangeIndex(table, shuffled, options.seed); });
+    checker.check("threaded_load", [&]() { return checkThreadedLoad(shuffled_rows); });
+    checker.check("stream_candles", [&]() { return checkStreaming(rows, table); });
+
+    std::printf("%d of %d checks passed\n", checker.checks() - checker.failures(), checker.checks());
+    return checker.failures() == 0 ? 0 : 1;
+}
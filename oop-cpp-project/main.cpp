@@ -1,209 +1,436 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <map>
-#include <limits>
-#include <cmath>
-#include <algorithm> 
-#include <iomanip>   
-
-#include "Utils.h"
-#include "Candlestick.h"
-
-/**
- * The main entry point of the program.
- * 
- * @return Returns 0 if the program executes successfully, or 1 if an error occurs.
- * 
- * This program performs various tasks:
- * 1. Reads and validates a CSV file for the weather dataset.
- * 2. Computes candlestick data for a country of my choice.
- * 3. Plots candlestick data (grouped by decades).
- * 4. Provides filtering options for candlestick data.
- * 5. Predicts future temperatures based on historical data.
- */
-
-int main() {
-    // Specify and Parse CSV File
-    std::string filename = "weather_data.csv";
-    auto data = readCSV(filename); ///< Parses the CSV file into a 2D vector of strings.
-
-    // Validate CSV Parsing
-    if (data.empty()) {
-        std::cerr << "Error: Failed to parse the CSV file or file is empty.\n";
-        return 1; // Exit with error code
-    }
-
-    // Display the first few rows for verification
-    std::cout << "First few rows of the CSV file:\n";
-    for (size_t i = 0; i < 5 && i < data.size(); ++i) {
-        for (const auto& cell : data[i]) {
-            std::cout << cell << " ";
-        }
-        std::cout << std::endl;
-    }
-
-    // --- Task 1: Candlestick Data Computation ---
-
-    try {
-        // Compute candlestick data for Austria ("AT") grouped by year
-        std::cout << "\nComputing candlestick data for Austria (AT) by year...\n";
-        auto candlesticks = computeCandlestickData(data, "AT", "year");
-
-        if (candlesticks.empty()) {
-            std::cerr << "No candlestick data could be computed. Check input data.\n";
-            return 1;
-        }
-
-        // Display the computed candlestick data
-        std::cout << "\nComputed Candlestick Data:\n";
-        for (const auto& candle : candlesticks) {
-            std::cout << "Date: " << candle.date
-                      << ", Open: " << candle.open
-                      << ", High: " << candle.high
-                      << ", Low: " << candle.low
-                      << ", Close: " << candle.close << std::endl;
-        }
-
-    // --- Task 2: Plot Candlestick Data ---
-
-        // Plot the candlestick data grouped by decade
-        std::cout << "\nText-Based Plot of Candlesticks for Austria (AT) by Decade:\n";
-        std::cout << "-----------------------------------\n";
-        plotGroupedCandlesticks(candlesticks);
-
-        // Main Menu for User Actions
-        char proceed;
-        do {
-            std::cout << "\nChoose an option:\n";
-            std::cout << "1. Filter and plot data (Task 3)\n";
-            std::cout << "2. Predict temperatures (Task 4)\n";
-            std::cout << "0. Exit\n";
-            std::cout << "Enter your choice: ";
-            int choice;
-            std::cin >> choice;
-    
-    // --- Task 3: Filtering Options ---
-
-            switch (choice) {
-                case 1: {
-                    std::cout << "\nWould you like to filter the data? (y/n): ";
-                    char filter_choice;
-                    std::cin >> filter_choice;
-
-                    if (filter_choice == 'y' || filter_choice == 'Y') {
-                        std::cout << "\nChoose a filtering option:\n";
-                        std::cout << "1. Filter by country\n";
-                        std::cout << "2. Filter by date range\n";
-                        std::cout << "3. Filter by temperature range\n";
-                        std::cout << "Enter your choice: ";
-                        int filter_option;
-                        std::cin >> filter_option;
-
-                        std::vector<Candlestick> filtered_data;
-
-                        switch (filter_option) {
-                            case 1: {
-                                // Display available countries
-                                displayAvailableCountries(data);
-
-                                // Filter by country
-                                std::string country_prefix;
-                                std::cout << "(Kindly input in UPPERCASE)\n";
-                                std::cout << "Enter the country prefix (e.g., 'AT' for Austria):";
-                                std::cin >> country_prefix;
-                                filtered_data = filterByCountry(data, country_prefix, "year");
-                                break;
-                            }
-                            case 2: {
-                                // Display available date range
-                                displayAvailableDateRange(data);
-
-                                // Filter by date range
-                                std::string start_date, end_date;
-                                std::cout << "Enter start date (YYYY): ";
-                                std::cin >> start_date;
-                                std::cout << "Enter end date (YYYY): ";
-                                std::cin >> end_date;
-                                filtered_data = filterByDateRange(candlesticks, start_date, end_date);
-                                break;
-                            }
-                            case 3: {
-                                // Display available temperature range
-                                displayAvailableTemperatureRange(data);
-
-                                // Filter by temperature range
-                                double min_temp, max_temp;
-                                std::cout << "Enter minimum temperature: ";
-                                std::cin >> min_temp;
-                                std::cout << "Enter maximum temperature: ";
-                                std::cin >> max_temp;
-
-                                std::cout << "Filtering candlesticks...\n";
-                                filtered_data = filterByTemperatureRange(candlesticks, min_temp, max_temp);
-                                break;
-                            }
-                            default:
-                                std::cerr << "Invalid choice. Exiting filtering...\n";
-                                return 1;
-                        }
-
-                        // Plot the filtered data
-                        if (!filtered_data.empty()) {
-                            std::cout << "\nFiltered and Plotted Candlestick Data:\n";
-                            plotGroupedCandlesticks(filtered_data);
-                        } else {
-                            std::cout << "No data available for the selected filter.\n";
-                        }
-                    }
-                    break;
-                }
-
-    // --- Task 4: Predictive Modelling ---
-
-                case 2: {
-                    // Predict temperatures
-                    std::cout << "\nTask 4: Predicting Temperatures\n";
-                    // Display available countries
-                    displayAvailableCountries(data);
-
-                    // Prompt user to select country
-                    std::string country_prefix;
-                    std::cout << "(Kindly input in UPPERCASE)\n";
-                    std::cout << "Enter country prefix for prediction (e.g., 'AT' for Austria):";
-                    std::cin >> country_prefix;
-
-                    // Prompt user for start and end years
-                    int startYear, endYear;
-                    std::cout << "Enter start year for prediction: ";
-                    std::cin >> startYear;
-                    std::cout << "Enter end year for prediction: ";
-                    std::cin >> endYear;
-
-                    // Perform prediction
-                    predictAndDisplayTemperatures(data, country_prefix, startYear, endYear);
-                    break;
-                }
-                case 0:
-                    std::cout << "Exiting program.\n";
-                    proceed = 'n';
-                    break;
-                default:
-                    std::cerr << "Invalid choice. Please try again.\n";
-                    break;
-            }
-
-            if (choice != 0) {
-                std::cout << "\nWould you like to perform another task? (y/n): ";
-                std::cin >> proceed;
-            }
-        } while (proceed == 'y' || proceed == 'Y');
-
-    } catch (const std::exception& e) {
-        // Handle any errors during computation or plotting
-        std::cerr << "An error occurred: " << e.what() << std::endl;
-        return 1; // Exit with error code
-    } 
-
-    return 0; // Program Exit Successfully
-}
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <limits>
+#include <cmath>
+#include <algorithm> 
+#include <iomanip>   
+#include <fstream>
+#include <stdexcept>
+
+#include "Utils.h"
+#include "Candlestick.h"
+#include "CandleRollup.h"
+#include "CandlestickAggregator.h"
+#include "CsvReader.h"
+#include "Instrumentation.h"
+#include "OnlineForecaster.h"
+#include "QueryEngine.h"
+#include "QueryServer.h"
+#include "TemperatureIntervalIndex.h"
+#include "WeatherTable.h"
+
+/**
+ * The main entry point of the program.
+ * 
+ * @param argc Number of command-line arguments.
+ * @param argv Command-line arguments; "--threads N" sets the number of CSV parser threads
+ *             (0 or omitted uses every core), "--rebuild-cache" re-parses the CSV and rewrites
+ *             weather_data.csv.cache, and "--no-cache" skips the snapshot entirely.
+ *             "--query Q" (repeatable) and "--query-file F" ("-" for stdin) run queries
+ *             non-interactively instead of the menu (see QueryEngine.h), writing to stdout or
+ *             to "--output F". "--serve PORT" or "--serve-unix PATH" instead keeps the table
+ *             resident and answers HTTP queries (see QueryServer.h) on "--workers N" threads.
+ *             "--stats F" writes per-stage timings and counters as JSON at exit ("-" for
+ *             stderr), and "--trace F" additionally writes a Chrome trace-event file.
+ *             "--forecast-state F" loads saved prediction state at start, folds in only the
+ *             newer rows, and saves it back at exit (see OnlineForecaster.h).
+ *             "--stream CC FRAME" writes one country's candles as CSV (like the "candles"
+ *             query) straight from the CSV file, without loading the table.
+ * @return Returns 0 if the program executes successfully, or 1 if an error occurs.
+ * 
+ * This program performs various tasks:
+ * 1. Reads and validates a CSV file for the weather dataset, parsing it once into a WeatherTable.
+ * 2. Computes candlestick data for a country of my choice.
+ * 3. Plots candlestick data (grouped by decades).
+ * 4. Provides filtering options for candlestick data.
+ * 5. Predicts future temperatures based on historical data.
+ */
+
+namespace {
+
+/**
+ * Parses the value of a numeric option as a whole non-negative integer.
+ *
+ * @param option The option name, for the error message.
+ * @param text The value given on the command line.
+ * @param max The largest accepted value.
+ * @return The value.
+ * @throws std::runtime_error if the text is not an integer in [0, max].
+ */
+unsigned long parseOptionNumber(const std::string& option, const std::string& text, unsigned long max) {
+    size_t used = 0;
+    unsigned long value = 0;
+    try {
+        if (!text.empty() && text[0] != '-' && text[0] != '+') {
+            value = std::stoul(text, &used);
+        }
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || value > max) {
+        throw std::runtime_error("Invalid value for " + option + ": " + text);
+    }
+    return value;
+}
+
+/**
+ * Saves the forecast state if a file was given, turning a failure into exit status 1.
+ *
+ * @param filename The state file, or empty to skip saving.
+ * @param forecasters The states to save.
+ * @param status The exit status so far.
+ * @return The exit status.
+ */
+int saveForecastState(const std::string& filename, const std::map<std::string, OnlineForecaster>& forecasters,
+                      int status) {
+    if (filename.empty() || saveForecasters(forecasters, filename)) {
+        return status;
+    }
+    std::cerr << "Error: Could not save forecast state to " << filename << "\n";
+    return 1;
+}
+
+/**
+ * Streams one country's candles from the CSV file as "date,open,high,low,close" rows.
+ *
+ * @param filename The CSV file.
+ * @param country_prefix The country prefix.
+ * @param time_frame The time frame name (see parseTimeFrame).
+ * @param output_file The output file, or empty for stdout.
+ * @return The exit status.
+ */
+int streamCandles(const std::string& filename, const std::string& country_prefix, const std::string& time_frame,
+                  const std::string& output_file) {
+    std::ofstream file;
+    if (!output_file.empty()) {
+        file.open(output_file);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open output file: " << output_file << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = output_file.empty() ? std::cout : file;
+
+    try {
+        ScopedTimer timer("stream");
+        TimeFrameSpec frame = parseTimeFrame(time_frame);
+        // The header waits for the first candle, so an unknown country prints only the error
+        bool header = false;
+        auto writeHeader = [&out, &header]() {
+            if (!header) {
+                out << "date,open,high,low,close\n";
+                header = true;
+            }
+        };
+        streamCandlestickData(filename, country_prefix, frame, [&out, &writeHeader](const Candlestick& candle) {
+            writeHeader();
+            out << candle.date << ',' << candle.open << ',' << candle.high << ','
+                << candle.low << ',' << candle.close << '\n';
+        });
+        writeHeader();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return out ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Command-line options
+    std::string filename = "weather_data.csv";
+    LoadOptions load_options;
+    load_options.threads = 0; // One parser thread per core unless overridden
+    load_options.cache_file = filename + ".cache";
+    std::vector<std::string> queries; ///< Non-empty selects batch mode.
+    std::string output_file;
+    ServerOptions server_options; ///< A port or socket path selects server mode.
+    std::string stats_file, trace_file; ///< Either one turns instrumentation on.
+    std::string forecast_state_file;
+    std::string stream_country, stream_frame; ///< A country selects stream mode.
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                load_options.threads = static_cast<unsigned>(parseOptionNumber(arg, argv[++i], 4096));
+            } else if (arg == "--rebuild-cache") {
+                load_options.rebuild_cache = true;
+            } else if (arg == "--no-cache") {
+                load_options.cache_file.clear();
+            } else if (arg == "--query" && i + 1 < argc) {
+                queries.push_back(argv[++i]);
+            } else if (arg == "--query-file" && i + 1 < argc) {
+                std::vector<std::string> lines = readQueryFile(argv[++i]);
+                queries.insert(queries.end(), lines.begin(), lines.end());
+            } else if (arg == "--output" && i + 1 < argc) {
+                output_file = argv[++i];
+            } else if (arg == "--serve" && i + 1 < argc) {
+                server_options.port = static_cast<int>(parseOptionNumber(arg, argv[++i], 65535));
+                if (server_options.port == 0) {
+                    throw std::runtime_error("Invalid value for --serve: 0");
+                }
+            } else if (arg == "--serve-unix" && i + 1 < argc) {
+                server_options.unix_socket = argv[++i];
+            } else if (arg == "--workers" && i + 1 < argc) {
+                server_options.workers = static_cast<unsigned>(parseOptionNumber(arg, argv[++i], 4096));
+            } else if (arg == "--stats" && i + 1 < argc) {
+                stats_file = argv[++i];
+            } else if (arg == "--trace" && i + 1 < argc) {
+                trace_file = argv[++i];
+            } else if (arg == "--forecast-state" && i + 1 < argc) {
+                forecast_state_file = argv[++i];
+            } else if (arg == "--stream" && i + 2 < argc) {
+                stream_country = argv[++i];
+                stream_frame = argv[++i];
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                std::cerr << "Usage: " << argv[0] << " [--threads N] [--rebuild-cache] [--no-cache]"
+                          << " [--query Q]... [--query-file F] [--output F]"
+                          << " [--serve PORT | --serve-unix PATH] [--workers N]"
+                          << " [--stats F] [--trace F] [--forecast-state F]"
+                          << " [--stream CC FRAME]\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        // Malformed option values and unreadable query files
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // Reports are written on every exit path below, including errors
+    if (!stats_file.empty() || !trace_file.empty()) {
+        Instrumentation::writeAtExit(stats_file, trace_file);
+    }
+
+    // Stream mode: one pass over the CSV file, in memory bounded by one candle
+    if (!stream_country.empty()) {
+        return streamCandles(filename, stream_country, stream_frame, output_file);
+    }
+
+    // Parse CSV File (or load its binary snapshot)
+    WeatherTable data;
+    {
+        ScopedTimer timer("load");
+        data = loadWeatherTable(filename, load_options); ///< Parsed once into typed columns.
+    }
+
+    // Validate CSV Parsing
+    if (data.empty()) {
+        std::cerr << "Error: Failed to parse the CSV file or file is empty.\n";
+        return 1; // Exit with error code
+    }
+
+    // Saved forecasters only need the rows appended since they were saved
+    std::map<std::string, OnlineForecaster> forecasters;
+    if (!forecast_state_file.empty() && std::ifstream(forecast_state_file).good() &&
+        !loadForecasters(forecast_state_file, forecasters)) {
+        std::cerr << "Warning: Ignoring unreadable forecast state " << forecast_state_file << "\n";
+    }
+
+    // Server mode: keep the table resident and answer queries until stopped
+    if (server_options.port > 0 || !server_options.unix_socket.empty()) {
+        QueryEngine engine(data, std::move(forecasters));
+        int status = serveQueries(engine, server_options);
+        return saveForecastState(forecast_state_file, engine.forecasterState(), status);
+    }
+
+    // Batch mode: run every query against the one loaded table, then exit
+    if (!queries.empty()) {
+        QueryEngine engine(data, std::move(forecasters));
+        if (output_file.empty()) {
+            int status = engine.runBatch(queries, std::cout) == 0 ? 0 : 1;
+            return saveForecastState(forecast_state_file, engine.forecasterState(), status);
+        }
+        std::ofstream output(output_file);
+        if (!output.is_open()) {
+            std::cerr << "Error: Could not open output file: " << output_file << "\n";
+            return 1;
+        }
+        int status = engine.runBatch(queries, output) == 0 ? 0 : 1;
+        return saveForecastState(forecast_state_file, engine.forecasterState(), status);
+    }
+
+    CsvReader reader(filename); ///< Memory-maps the CSV file for the preview below.
+
+    // Display the first few rows for verification
+    std::cout << "First few rows of the CSV file:\n";
+    reader.forEachRow([](size_t i, const std::vector<std::string_view>& cells) {
+        for (const auto& cell : cells) {
+            std::cout << cell << " ";
+        }
+        std::cout << std::endl;
+        return i + 1 < 5;
+    });
+
+    // --- Task 1: Candlestick Data Computation ---
+
+    try {
+        // Compute candlestick data for Austria ("AT") grouped by year
+        std::cout << "\nComputing candlestick data for Austria (AT) by year...\n";
+        // Every country's rollup is built once and serves the menu's candle series
+        const std::map<std::string, CandleRollup> rollups = buildCandleRollups(data);
+        auto candlesticks = findCandleRollup(rollups, "AT").candles(TimeFrame::Year);
+
+        if (candlesticks.empty()) {
+            std::cerr << "No candlestick data could be computed. Check input data.\n";
+            return 1;
+        }
+        TemperatureIntervalIndex temperature_index(candlesticks);
+
+        // Display the computed candlestick data
+        std::cout << "\nComputed Candlestick Data:\n";
+        for (const auto& candle : candlesticks) {
+            std::cout << "Date: " << candle.date
+                      << ", Open: " << candle.open
+                      << ", High: " << candle.high
+                      << ", Low: " << candle.low
+                      << ", Close: " << candle.close << std::endl;
+        }
+
+    // --- Task 2: Plot Candlestick Data ---
+
+        // Plot the candlestick data grouped by decade
+        std::cout << "\nText-Based Plot of Candlesticks for Austria (AT) by Decade:\n";
+        std::cout << "-----------------------------------\n";
+        plotGroupedCandlesticks(candlesticks);
+
+        // Main Menu for User Actions
+        char proceed;
+        do {
+            std::cout << "\nChoose an option:\n";
+            std::cout << "1. Filter and plot data (Task 3)\n";
+            std::cout << "2. Predict temperatures (Task 4)\n";
+            std::cout << "0. Exit\n";
+            std::cout << "Enter your choice: ";
+            int choice;
+            std::cin >> choice;
+    
+    // --- Task 3: Filtering Options ---
+
+            switch (choice) {
+                case 1: {
+                    std::cout << "\nWould you like to filter the data? (y/n): ";
+                    char filter_choice;
+                    std::cin >> filter_choice;
+
+                    if (filter_choice == 'y' || filter_choice == 'Y') {
+                        std::cout << "\nChoose a filtering option:\n";
+                        std::cout << "1. Filter by country\n";
+                        std::cout << "2. Filter by date range\n";
+                        std::cout << "3. Filter by temperature range\n";
+                        std::cout << "Enter your choice: ";
+                        int filter_option;
+                        std::cin >> filter_option;
+
+                        std::vector<Candlestick> filtered_data;
+
+                        switch (filter_option) {
+                            case 1: {
+                                // Display available countries
+                                displayAvailableCountries(data);
+
+                                // Filter by country
+                                std::string country_prefix;
+                                std::cout << "(Kindly input in UPPERCASE)\n";
+                                std::cout << "Enter the country prefix (e.g., 'AT' for Austria):";
+                                std::cin >> country_prefix;
+                                filtered_data = filterByCountry(rollups, country_prefix, "year");
+                                break;
+                            }
+                            case 2: {
+                                // Display available date range
+                                displayAvailableDateRange(data);
+
+                                // Filter by date range
+                                std::string start_date, end_date;
+                                std::cout << "Enter start date (YYYY): ";
+                                std::cin >> start_date;
+                                std::cout << "Enter end date (YYYY): ";
+                                std::cin >> end_date;
+                                filtered_data = filterByDateRange(candlesticks, start_date, end_date);
+                                break;
+                            }
+                            case 3: {
+                                // Display available temperature range
+                                displayAvailableTemperatureRange(data);
+
+                                // Filter by temperature range
+                                double min_temp, max_temp;
+                                std::cout << "Enter minimum temperature: ";
+                                std::cin >> min_temp;
+                                std::cout << "Enter maximum temperature: ";
+                                std::cin >> max_temp;
+
+                                std::cout << "Filtering candlesticks...\n";
+                                filtered_data = filterByTemperatureRange(temperature_index, min_temp, max_temp);
+                                break;
+                            }
+                            default:
+                                std::cerr << "Invalid choice. Exiting filtering...\n";
+                                return 1;
+                        }
+
+                        // Plot the filtered data
+                        if (!filtered_data.empty()) {
+                            std::cout << "\nFiltered and Plotted Candlestick Data:\n";
+                            plotGroupedCandlesticks(filtered_data);
+                        } else {
+                            std::cout << "No data available for the selected filter.\n";
+                        }
+                    }
+                    break;
+                }
+
+    // --- Task 4: Predictive Modelling ---
+
+                case 2: {
+                    // Predict temperatures
+                    std::cout << "\nTask 4: Predicting Temperatures\n";
+                    // Display available countries
+                    displayAvailableCountries(data);
+
+                    // Prompt user to select country
+                    std::string country_prefix;
+                    std::cout << "(Kindly input in UPPERCASE)\n";
+                    std::cout << "Enter country prefix for prediction (e.g., 'AT' for Austria):";
+                    std::cin >> country_prefix;
+
+                    // Prompt user for start and end years
+                    int startYear, endYear;
+                    std::cout << "Enter start year for prediction: ";
+                    std::cin >> startYear;
+                    std::cout << "Enter end year for prediction: ";
+                    std::cin >> endYear;
+
+                    // Perform prediction, reusing the country's running fit where it covers the window
+                    const OnlineForecaster& forecaster = updateForecaster(forecasters, data, country_prefix, 2);
+                    predictAndDisplayTemperatures(rollups, country_prefix, startYear, endYear, std::cout, &forecaster);
+                    break;
+                }
+                case 0:
+                    std::cout << "Exiting program.\n";
+                    proceed = 'n';
+                    break;
+                default:
+                    std::cerr << "Invalid choice. Please try again.\n";
+                    break;
+            }
+
+            if (choice != 0) {
+                std::cout << "\nWould you like to perform another task? (y/n): ";
+                std::cin >> proceed;
+            }
+        } while (proceed == 'y' || proceed == 'Y');
+
+    } catch (const std::exception& e) {
+        // Handle any errors during computation or plotting
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return 1; // Exit with error code
+    } 
+
+    return saveForecastState(forecast_state_file, forecasters, 0); // Program Exit Successfully
+}